@@ -111,6 +111,7 @@ typedef struct _genlib_data t_genlib_data;
 typedef struct {
 	int					dim, channels;
 	t_sample *			data;
+	int					planar;	// each channel stored contiguously (dim samples), rather than interleaved
 } t_genlib_data_info;
 
 typedef void (*setparameter_method) (CommonState *, long, t_param, void *);
@@ -224,20 +225,90 @@ extern "C" {
 // #	define RAND_MAX		UINT32_MAX
 // #endif // GENLIB_USE_ARMMATH
 
+// Fast math approximations are chosen per function, by defining GENLIB_FASTMATH_<FUNCTION> as 
+// GENLIB_FASTMATH_FAST (minimax polynomials, with errors from about 1e-7 to 1e-4, see genlib_ops.h),
+// or GENLIB_FASTMATH_FASTER (Mineiro's approximations, cheaper but with errors of 1e-3 or worse).
+// GENLIB_USE_FASTMATH selects the faster tier for every function that is not defined otherwise.
+#define GENLIB_FASTMATH_EXACT	(0)
+#define GENLIB_FASTMATH_FAST	(1)
+#define GENLIB_FASTMATH_FASTER	(2)
+
 #if defined(GENLIB_USE_FASTMATH)
-#	include <math.h>
+#	ifndef GENLIB_FASTMATH_TAN
+#		define GENLIB_FASTMATH_TAN		GENLIB_FASTMATH_FASTER
+#	endif
+#	ifndef GENLIB_FASTMATH_EXP
+#		define GENLIB_FASTMATH_EXP		GENLIB_FASTMATH_FASTER
+#	endif
+#	ifndef GENLIB_FASTMATH_LOG2
+#		define GENLIB_FASTMATH_LOG2		GENLIB_FASTMATH_FASTER
+#	endif
+#	ifndef GENLIB_FASTMATH_POW
+#		define GENLIB_FASTMATH_POW		GENLIB_FASTMATH_FASTER
+#	endif
+#	ifndef GENLIB_FASTMATH_ATAN2
+#		define GENLIB_FASTMATH_ATAN2	GENLIB_FASTMATH_FASTER
+#	endif
+#	ifndef GENLIB_FASTMATH_TANH
+#		define GENLIB_FASTMATH_TANH		GENLIB_FASTMATH_FASTER
+#	endif
+#	if !defined(GENLIB_USE_ARMMATH)
+#		ifndef GENLIB_FASTMATH_SIN
+#			define GENLIB_FASTMATH_SIN	GENLIB_FASTMATH_FASTER
+#		endif
+#		ifndef GENLIB_FASTMATH_COS
+#			define GENLIB_FASTMATH_COS	GENLIB_FASTMATH_FASTER
+#		endif
+#	endif
+#endif // GENLIB_USE_FASTMATH
+
+#if GENLIB_FASTMATH_TAN || GENLIB_FASTMATH_EXP || GENLIB_FASTMATH_LOG2 || GENLIB_FASTMATH_POW || GENLIB_FASTMATH_ATAN2 || GENLIB_FASTMATH_TANH || GENLIB_FASTMATH_SIN || GENLIB_FASTMATH_COS
+// the math library must be declared before its names are redefined:
+#	include <cmath>
+#endif
+
+#if GENLIB_FASTMATH_TAN == GENLIB_FASTMATH_FAST
+#	define tan(x)		fasttanfull(x)
+#elif GENLIB_FASTMATH_TAN == GENLIB_FASTMATH_FASTER
 #	define tan(x)		fastertanfull(x)
+#endif
+#if GENLIB_FASTMATH_EXP == GENLIB_FASTMATH_FAST
+#	define exp(x)		fastexp(x)
+#elif GENLIB_FASTMATH_EXP == GENLIB_FASTMATH_FASTER
 #	define exp(x)		fasterexp(x)
+#endif
+#if GENLIB_FASTMATH_LOG2 == GENLIB_FASTMATH_FAST
+#	define log2(x)		fastlog2(x)
+#elif GENLIB_FASTMATH_LOG2 == GENLIB_FASTMATH_FASTER
 #	define log2(x)		fasterlog2(x)
+#endif
+#if GENLIB_FASTMATH_POW == GENLIB_FASTMATH_FAST
+#	define pow(x,y)		fastpow(x,y)
+#	define pow2(x)		fastpow2(x)
+#elif GENLIB_FASTMATH_POW == GENLIB_FASTMATH_FASTER
 #	define pow(x,y)		fasterpow(x,y)
 #	define pow2(x)		fasterpow2(x)
+#endif
+#if GENLIB_FASTMATH_ATAN2 == GENLIB_FASTMATH_FAST
+#	define atan2(x,y)	fastatan2(x,y)
+#elif GENLIB_FASTMATH_ATAN2 == GENLIB_FASTMATH_FASTER
 #	define atan2(x,y)	fasteratan2(x,y)
+#endif
+#if GENLIB_FASTMATH_TANH == GENLIB_FASTMATH_FAST
+#	define tanh(x)		fasttanh(x)
+#elif GENLIB_FASTMATH_TANH == GENLIB_FASTMATH_FASTER
 #	define tanh(x)		fastertanh(x)
-#	if !defined(GENLIB_USE_ARMMATH)
-#		define sin(x)	fastersinfull(x)
-#		define cos(x)	fastercosfull(x)
-#	endif
-#endif // GENLIB_USE_FASTMATH
+#endif
+#if GENLIB_FASTMATH_SIN == GENLIB_FASTMATH_FAST
+#	define sin(x)		fastsinfull(x)
+#elif GENLIB_FASTMATH_SIN == GENLIB_FASTMATH_FASTER
+#	define sin(x)		fastersinfull(x)
+#endif
+#if GENLIB_FASTMATH_COS == GENLIB_FASTMATH_FAST
+#	define cos(x)		fastcosfull(x)
+#elif GENLIB_FASTMATH_COS == GENLIB_FASTMATH_FASTER
+#	define cos(x)		fastercosfull(x)
+#endif
 
 	// string reference handling:
 	void *genlib_obtain_reference_from_string(const char *name);
@@ -256,6 +327,7 @@ extern "C" {
 	t_genlib_data *genlib_obtain_data_from_reference(void *ref);
 	t_genlib_err genlib_data_getinfo(t_genlib_data *b, t_genlib_data_info *info);
 	void genlib_data_resize(t_genlib_data *b, long dim, long channels);
+	void genlib_data_setplanar(t_genlib_data *b, int planar);
 	void genlib_data_setbuffer(t_genlib_data *b, void *ref);
 	void genlib_data_release(t_genlib_data *b);
 	void genlib_data_setcursor(t_genlib_data *b, long cursor);
@@ -268,6 +340,7 @@ extern "C" {
 	size_t genlib_getstatesize(CommonState *cself, getparameter_method getmethod);
 	short genlib_getstate(CommonState *cself, char *state, getparameter_method getmethod);
 	short genlib_setstate(CommonState *cself, const char *state, setparameter_method setmethod);
+	short genlib_morphstate(CommonState *cself, const char *a, const char *b, t_param mix, setparameter_method setmethod);
 
 }; // extern "C"
 
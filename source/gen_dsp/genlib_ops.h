@@ -30,6 +30,10 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #	include <cmath>
 #endif
 
+#if defined(__SSE__) || defined(_M_X64)
+#	include <xmmintrin.h> // _mm_setcsr
+#endif
+
 //////////// genlib_ops.h ////////////
 
 // system constants
@@ -46,6 +50,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #	define GENLIB_NO_DENORM_TEST 1
 #endif // defined(MSP_ON_CLANG) || defined(ARM_MATH_CM4) || defined(ARM_MATH_CM7)
 
+// nor when the FPU flushes them to zero, see genlib_flush_denormals():
+#if defined(GENLIB_FLUSH_DENORMALS) && !defined(GENLIB_NO_DENORM_TEST)
+#	define GENLIB_NO_DENORM_TEST 1
+#endif
+
 #ifdef GENLIB_USE_FLOAT32
 #	define GENLIB_EPSILON GENLIB_FLT_EPSILON
 #else
@@ -63,7 +72,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #	define GENLIB_FIX_NAN_FLOAT(v)			((v)=GENLIB_IS_NAN_FLOAT(v)?0.f:(v))
 
 #	ifdef GENLIB_NO_DENORM_TEST
-#		define GENLIB_IS_DENORM_FLOAT(v)	(v)
+#		define GENLIB_IS_DENORM_FLOAT(v)	(0)
 #		define GENLIB_FIX_DENORM_FLOAT(v)	(v)
 #	else
 #		ifdef WIN32
@@ -82,7 +91,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #	define GENLIB_FIX_NAN_DOUBLE(v)		((v)=GENLIB_IS_NAN_DOUBLE(v)?0.:(v))
 
 #	ifdef GENLIB_NO_DENORM_TEST
-#		define GENLIB_IS_DENORM_DOUBLE(v)	(v)
+#		define GENLIB_IS_DENORM_DOUBLE(v)	(0)
 #		define GENLIB_FIX_DENORM_DOUBLE(v)	(v)
 #	else // GENLIB_NO_DENORM_TEST
 #		define GENLIB_IS_DENORM_DOUBLE(v)	((((((uint32_t *)&(v))[1])&0x7fe00000)==0)&&((v)!=0.))
@@ -103,11 +112,34 @@ inline t_sample fixnan(t_sample v) { return GENLIB_FIX_NAN(v); }
 inline t_sample fixdenorm(t_sample v) { return GENLIB_FIX_DENORM(v); }
 inline t_sample isdenorm(t_sample v) { return GENLIB_IS_DENORM(v); }
 
+// sets the FPU to flush denormals to zero (FZ on ARM, FTZ & DAZ on x86),
+// so that feedback paths decaying towards silence never slow down on denormal arithmetic.
+// This only affects the calling thread (or on Cortex-M, the calling interrupt handler),
+// so with GENLIB_FLUSH_DENORMALS it is called at the start of each audio callback.
+inline void genlib_flush_denormals() {
+#if defined(__arm__) && defined(__VFP_FP__) && !defined(__SOFTFP__)
+	uint32_t fpscr;
+	__asm__ volatile ("vmrs %0, fpscr" : "=r" (fpscr));
+	__asm__ volatile ("vmsr fpscr, %0" : : "r" (fpscr | (1u << 24)));
+#elif defined(__aarch64__)
+	uint64_t fpcr;
+	__asm__ volatile ("mrs %0, fpcr" : "=r" (fpcr));
+	__asm__ volatile ("msr fpcr, %0" : : "r" (fpcr | (1u << 24)));
+#elif defined(__SSE__) || defined(_M_X64)
+	_mm_setcsr(_mm_getcsr() | 0x8040);
+#endif
+}
+
 inline t_sample fasterpow(t_sample x, t_sample p);
 inline t_sample fasterexp(t_sample x);
 inline t_sample fastercosfull(t_sample x);
 inline t_sample fastersinfull(t_sample x);
 inline t_sample fastertanfull(t_sample x);
+inline t_sample fastpow(t_sample x, t_sample p);
+inline t_sample fastexp(t_sample x);
+inline t_sample fastcosfull(t_sample x);
+inline t_sample fastsinfull(t_sample x);
+inline t_sample fasttanfull(t_sample x);
 
 inline t_sample safemod(t_sample f, t_sample m) {
 	if (m > GENLIB_DBL_EPSILON || m < -GENLIB_DBL_EPSILON) {
@@ -497,6 +529,154 @@ inline t_sample fastertanh(t_sample x) {
 	return (t_sample)genlib_fastertanh((float)x);
 }
 
+////////////////////////////////////////////////////////////////
+
+// The "fast" tier of fastmath: minimax polynomials. 
+// Their worst errors in float32, as measured by genlib_bench.cpp over typical ranges, are:
+// sin, cos: 8e-7 absolute (so relative error grows near the zero crossings)
+// tan: 8.4e-5 relative (within -1.5..1.5, and worse closer to +/-pi/2, as cos approaches 0)
+// exp: 3.6e-7 relative
+// log2: 5.6e-7 absolute
+// pow: 6.6e-7 relative (an absolute 4.8e-3 for results up to 1e4)
+// atan2: 1.9e-6 absolute (2.3e-5 relative near 0)
+// tanh: 3.3e-7 absolute
+
+// sin(2*pi*z) for z within -0.25..0.25, degree 9 minimax polynomial (error < 1.3e-8):
+inline float genlib_sin2pi_poly(float z) {
+	const float z2 = z*z;
+	return z*(6.28318530189f + z2*(-41.3416918643f + z2*(81.6032657288f 
+		+ z2*(-76.5982079203f + z2*39.8732317779f))));
+}
+
+// cos(2*pi*x), for any x:
+inline float genlib_fastcos2pi(float x) {
+	// wrap to -0.5..0.5, then cos(2*pi*x) = sin(2*pi*(0.25 - |x|)):
+	x -= float(int(x + ((x < 0) ? -0.5f : 0.5f)));
+	return genlib_sin2pi_poly(0.25f - ((x < 0) ? -x : x));
+}
+
+inline float genlib_fastcosfull(float x) {
+	static const float invtwopi = 0.15915494309189534f;
+	return genlib_fastcos2pi(x * invtwopi);
+}
+
+inline float genlib_fastsinfull(float x) {
+	static const float invtwopi = 0.15915494309189534f;
+	return genlib_fastcos2pi(x * invtwopi - 0.25f);
+}
+
+inline float genlib_fasttanfull(float x) {
+	static const float invtwopi = 0.15915494309189534f;
+	const float t = x * invtwopi;
+	return genlib_fastcos2pi(t - 0.25f) / genlib_fastcos2pi(t);
+}
+
+// 2^p, as 2^floor(p) in the exponent bits, times a degree 5 minimax polynomial for 2^fract(p) (relative error < 7.5e-8),
+// for p already within -126..127:
+inline float genlib_fastpow2_inrange(float clipp) {
+	// floor, without a branch:
+	const int n = int(clipp) - int(clipp < float(int(clipp)));
+	const float f = clipp - float(n);
+	const float y = 0.999999925064f + f*(0.6931530732f + f*(0.240153617045f + f*(0.05582631805f 
+		+ f*(0.00898934009471f + f*0.00187757667337f))));
+	union { uint32_t i; float f; } v = { cast_uint32_t(n + 127) << 23 };
+	return y * v.f;
+}
+
+inline float genlib_fastpow2(float p) {
+	return genlib_fastpow2_inrange((p < -126.f) ? -126.f : ((p > 127.f) ? 127.f : p));
+}
+
+inline float genlib_fastexp(float p) {
+	return genlib_fastpow2(1.442695040f * p);
+}
+
+// log2(x) for x > 0, as the exponent bits plus log2 of the mantissa (scaled to 0.707..1.414), 
+// via a degree 5 minimax polynomial in s = (m-1)/(m+1) (error < 3e-8):
+inline float genlib_fastlog2(float x) {
+	union { float f; uint32_t i; } vx = { x };
+	int e = int((vx.i >> 23) & 0xff) - 127;
+	vx.i = (vx.i & 0x007fffff) | 0x3f800000;
+	if (vx.f > 1.41421356f) {
+		vx.f *= 0.5f;
+		e++;
+	}
+	const float s = (vx.f - 1.f) / (vx.f + 1.f);
+	const float s2 = s*s;
+	return e + s*(2.88539128937f + s2*(0.961470808954f + s2*0.598973885686f));
+}
+
+// for x > 0:
+inline float genlib_fastpow(float x, float p) {
+	return genlib_fastpow2(p * genlib_fastlog2(x));
+}
+
+// atan of the smaller over the larger of |y| and |x|, by a degree 11 minimax polynomial (error < 1.7e-6), 
+// then mapped to the quadrant:
+inline float genlib_fastatan2(float y, float x) {
+	const float ax = (x < 0) ? -x : x;
+	const float ay = (y < 0) ? -y : y;
+	const float mx = (ax > ay) ? ax : ay;
+	const float mn = (ax > ay) ? ay : ax;
+	if (mx == 0.f) return 0.f;
+	const float r = mn / mx;
+	const float r2 = r*r;
+	float a = r*(0.999977219082f + r2*(-0.33262282789f + r2*(0.193540376084f 
+		+ r2*(-0.11642648197f + r2*(0.052647351466f + r2*-0.0117191357343f)))));
+	if (ay > ax) a = 1.5707963267948966f - a;
+	if (x < 0) a = 3.1415926535897932f - a;
+	return (y < 0) ? -a : a;
+}
+
+// rational approximation as used by Eigen, accurate to a few ulp within +/-7.9, beyond which tanh rounds to +/-1:
+inline float genlib_fasttanh(float x) {
+	const float clip = 7.90531110763549805f;
+	x = (x < -clip) ? -clip : ((x > clip) ? clip : x);
+	const float x2 = x*x;
+	const float p = x*(4.89352455891786e-03f + x2*(6.37261928875436e-04f + x2*(1.48572235717979e-05f 
+		+ x2*(5.12229709037114e-08f + x2*(-8.60467152213735e-11f + x2*(2.00018790482477e-13f + x2*-2.76076847742355e-16f))))));
+	const float q = 4.89352518554385e-03f + x2*(2.26843463243900e-03f + x2*(1.18534705686654e-04f + x2*1.19825839466702e-06f));
+	return p / q;
+}
+
+////////////////////////////////////////////////////////////////
+
+inline t_sample fasttanfull(t_sample x) {
+	return (t_sample)genlib_fasttanfull((float)x);
+}
+
+inline t_sample fastsinfull(t_sample x) {
+	return (t_sample)genlib_fastsinfull((float)x);
+}
+
+inline t_sample fastcosfull(t_sample x) {
+	return (t_sample)genlib_fastcosfull((float)x);
+}
+
+inline t_sample fastexp(t_sample x) {
+	return (t_sample)genlib_fastexp((float)x);
+}
+
+inline t_sample fastlog2(t_sample x) {
+	return (t_sample)genlib_fastlog2((float)x);
+}
+
+inline t_sample fastpow(t_sample x, t_sample p) {
+	return (t_sample)genlib_fastpow((float)x, (float)p);
+}
+
+inline t_sample fastpow2(t_sample p) {
+	return (t_sample)genlib_fastpow2((float)p);
+}
+
+inline t_sample fastatan2(t_sample y, t_sample x) {
+	return (t_sample)genlib_fastatan2((float)y, (float)x);
+}
+
+inline t_sample fasttanh(t_sample x) {
+	return (t_sample)genlib_fasttanh((float)x);
+}
+
 /****************************************************************/
 
 
@@ -650,6 +830,111 @@ inline t_sample triangle(t_sample phase, t_sample p1) {
 		return t_sample((p1==1.) ? phase : 1. - ((phase - p1) / (1. - p1)));
 }
 
+// Block versions of the stateless operators, for hand-written C++ (e.g. target inserts) that works a block at a time.
+// Each writes n samples to out from the input span(s), with the other arguments constant over the block;
+// out may be the same as an input, but should not otherwise overlap it.
+// The loops have no branches or calls, so that they vectorize on the computer (and pipeline well on the Daisy),
+// and give the same results as the per-sample operators, except where noted.
+#if defined(__GNUC__)
+#define GENLIB_UNROLL4 _Pragma("GCC unroll 4")
+#else
+#define GENLIB_UNROLL4
+#endif
+
+// as wrap(), for inputs within +/- 2^31 ranges of lo:
+inline void genlib_block_wrap(t_sample * out, long n, const t_sample * in, t_sample lo1, t_sample hi1) {
+	const t_sample lo = minimum(lo1, hi1), hi = maximum(lo1, hi1);
+	const t_sample range = hi - lo;
+	if (range <= 0.000000001) {
+		for (long i=0; i<n; i++) out[i] = (in[i] < lo) ? lo : ((in[i] < hi) ? in[i] : lo);
+		return;
+	}
+	for (long i=0; i<n; i++) {
+		const t_sample v = in[i];
+		const t_sample numWraps = t_sample(int32_t((v-lo)/range) - int32_t(v < lo));
+		const t_sample w = v - range * numWraps;
+		// (nested rather than &&, which GCC will not turn into a vector select)
+		out[i] = (v < lo) ? w : ((v < hi) ? v : w);
+	}
+}
+
+// as fold(), for inputs within +/- 2^31 ranges of lo (may differ from fold() in the last bit when folding more than once):
+inline void genlib_block_fold(t_sample * out, long n, const t_sample * in, t_sample lo1, t_sample hi1) {
+	const t_sample lo = minimum(lo1, hi1), hi = maximum(lo1, hi1);
+	const t_sample range = hi - lo;
+	if (range == 0) {
+		for (long i=0; i<n; i++) out[i] = lo;
+		return;
+	}
+	for (long i=0; i<n; i++) {
+		const t_sample v = in[i];
+		const int32_t numWraps = int32_t((v-lo)/range) - int32_t(v < lo);
+		const t_sample w = v - range * t_sample(numWraps);
+		// flipped for odd folds, by multiplying rather than selecting, which is exact and which GCC will vectorize:
+		const t_sample odd = t_sample(numWraps & 1);
+		const t_sample f = (hi + lo - w) * odd + w * (t_sample(1) - odd);
+		out[i] = (v < lo) ? f : ((v < hi) ? v : f);
+	}
+}
+
+inline void genlib_block_clamp(t_sample * out, long n, const t_sample * in, t_sample minVal, t_sample maxVal) {
+	for (long i=0; i<n; i++) out[i] = clamp(in[i], minVal, maxVal);
+}
+
+inline void genlib_block_mix(t_sample * out, long n, const t_sample * x, const t_sample * y, t_sample a) {
+	for (long i=0; i<n; i++) out[i] = mix(x[i], y[i], a);
+}
+
+// or with a crossfade per sample:
+inline void genlib_block_mix(t_sample * out, long n, const t_sample * x, const t_sample * y, const t_sample * a) {
+	for (long i=0; i<n; i++) out[i] = mix(x[i], y[i], a[i]);
+}
+
+// only the linear scale (power 1) vectorizes; other powers call pow() for each sample, as scale() does:
+inline void genlib_block_scale(t_sample * out, long n, const t_sample * in, t_sample inlow, t_sample inhigh, t_sample outlow, t_sample outhigh, t_sample power) {
+	if (power != t_sample(1)) {
+		for (long i=0; i<n; i++) out[i] = scale(in[i], inlow, inhigh, outlow, outhigh, power);
+		return;
+	}
+	const t_sample inscale = safediv(1., inhigh - inlow);
+	const t_sample outdiff = outhigh - outlow;
+	for (long i=0; i<n; i++) out[i] = ((in[i] - inlow) * inscale) * outdiff + outlow;
+}
+
+// dbtoa() and mtof() here use genlib_fastpow2(), which vectorizes where pow() and exp() cannot, 
+// and is within 5e-7 (relative) of them.
+// out[i] = scale * 2^(in[i] * mul + add), with the exponent clipped in a separate pass, 
+// as GCC will not vectorize a float to int conversion of a select:
+inline void genlib_block_pow2(t_sample * out, long n, const t_sample * in, t_sample mul, t_sample add, t_sample scale) {
+	for (long i=0; i<n; i++) {
+		const t_sample p = in[i] * mul + add;
+		out[i] = (p < t_sample(-126)) ? t_sample(-126) : ((p > t_sample(127)) ? t_sample(127) : p);
+	}
+	for (long i=0; i<n; i++) out[i] = scale * t_sample(genlib_fastpow2_inrange(float(out[i])));
+}
+
+inline void genlib_block_dbtoa(t_sample * out, long n, const t_sample * in) {
+	// 10^(in/20) = 2^(in * log2(10)/20):
+	genlib_block_pow2(out, n, in, t_sample(0.166096404744368), 0, 1);
+}
+
+inline void genlib_block_mtof(t_sample * out, long n, const t_sample * in, t_sample tuning=440.) {
+	// tuning * 2^((in-69)/12):
+	genlib_block_pow2(out, n, in, t_sample(1./12.), t_sample(-69./12.), tuning);
+}
+
+// computed in t_sample throughout, where triangle() computes the falling half in double (so within 1e-7 of it in float32):
+inline void genlib_block_triangle(t_sample * out, long n, const t_sample * phases, t_sample p1) {
+	p1 = clamp(p1, 0., 1.);
+	genlib_block_wrap(out, n, phases, 0., 1.);
+	for (long i=0; i<n; i++) {
+		const t_sample phase = out[i];
+		const t_sample up = (p1 != 0) ? phase/p1 : t_sample(0);
+		const t_sample down = (p1 == 1) ? phase : t_sample(1) - ((phase - p1) / (t_sample(1) - p1));
+		out[i] = (phase < p1) ? up : down;
+	}
+}
+
 struct Delta {
 	t_sample history;
 	Delta() { reset(); }
@@ -660,6 +945,16 @@ struct Delta {
 		history = in1;
 		return ret;
 	}
+
+	// block version: each output depends only on two inputs, so this vectorizes
+	// (working backwards, so that out may be the same as in):
+	void process(t_sample * out, long n, const t_sample * in) {
+		if (n <= 0) return;
+		const t_sample last = in[n-1];
+		for (long i=n-1; i>0; i--) out[i] = in[i] - in[i-1];
+		out[0] = in[0] - history;
+		history = last;
+	}
 };
 struct Change {
 	t_sample history;
@@ -671,6 +966,15 @@ struct Change {
 		history = in1;
 		return sign(ret);
 	}
+
+	// block version, as Delta::process():
+	void process(t_sample * out, long n, const t_sample * in) {
+		if (n <= 0) return;
+		const t_sample last = in[n-1];
+		for (long i=n-1; i>0; i--) out[i] = sign(in[i] - in[i-1]);
+		out[0] = sign(in[0] - history);
+		history = last;
+	}
 };
 
 struct Rate {
@@ -798,18 +1102,57 @@ struct DCBlock {
 		y1 = y;
 		return y;
 	}
+
+	// block version: the feedback cannot vectorize, but the state stays in registers:
+	void process(t_sample * out, long n, const t_sample * in) {
+		t_sample x = x1, y = y1;
+		GENLIB_UNROLL4
+		for (long i=0; i<n; i++) {
+			const t_sample v = in[i];
+			y = v - x + y*t_sample(0.9997);
+			x = v;
+			out[i] = y;
+		}
+		x1 = x;
+		y1 = y;
+	}
 };
 
 #ifdef GENLIB_USE_FLOAT32
+// Noise runs several independent xoshiro128+ streams side by side, 
+// which the compiler can keep in SIMD lanes (or at least interleave in the pipeline),
+// and hands out their interleaved outputs one sample at a time, or a block at a time via fill()
+#ifndef GENLIB_NOISE_LANES
+#if defined(__arm__)
+#define GENLIB_NOISE_LANES (4)
+#else
+#define GENLIB_NOISE_LANES (8)
+#endif
+#endif
+// step() is kept out of line: inlined into a loop, the compiler tends to promote all the lane states to
+// (too few) scalar registers rather than keeping them in vectors
+#if defined(__GNUC__)
+#define GENLIB_NOISE_STEP __attribute__((noinline))
+#else
+#define GENLIB_NOISE_STEP
+#endif
 struct Noise {
-    uint32_t state[4];
+    uint32_t state[4][GENLIB_NOISE_LANES];
+	t_sample buffer[GENLIB_NOISE_LANES];
+	int index;
 
 	// uses system clock to generate a random seed
 	// ensures distinct seeds even if creating several Noise objects at the same clock value
 	static uint64_t uniqueTickCount(void) {
+	#ifdef OOPSY_TARGET_HOST
+		// host renders must be repeatable, and run on several threads at once,
+		// so genlib_ticks() is a counter per render there
+		return genlib_ticks();
+	#else
 		static uint64_t lasttime = 0;
 		uint64_t time = genlib_ticks();
 		return (time <= lasttime) ? (++lasttime) : (lasttime = time);
+	#endif
 	}
     
     Noise() { reset(); }
@@ -818,7 +1161,11 @@ struct Noise {
 	void reset(t_sample seed) { 
 		//uint64_t x = (uint64_t)(ldexp((double)seed, 53));
 		uint64_t x = (uint64_t)(seed*exp2f(53.f));
-		state[3] = splitmix32(state[2] = splitmix32(state[1] = splitmix32(state[0] = splitmix32(x))));
+		// each lane is seeded as a separate generator would be (lane 0 exactly as before):
+		for (int l=0; l<GENLIB_NOISE_LANES; l++) {
+			state[3][l] = splitmix32(state[2][l] = splitmix32(state[1][l] = splitmix32(state[0][l] = splitmix32(x + l))));
+		}
+		index = GENLIB_NOISE_LANES;
 	}
 	void reset() { reset( uniqueTickCount() ); }
 	
@@ -828,20 +1175,48 @@ struct Noise {
     and related and neighboring rights to this software to the public domain
     worldwide. This software is distributed without any warranty.
     See <http://creativecommons.org/publicdomain/zero/1.0/>. */
-	inline t_sample operator()() {
-		const uint32_t result = state[0] + state[3];
-        const uint32_t t = state[1] << 9;
-        state[2] ^= state[0];
-        state[3] ^= state[1];
-        state[1] ^= state[2];
-        state[0] ^= state[3];
-        state[2] ^= t;
-        state[3] = (state[3] << 11) | (state[3] >> 21); // rotl(s[3], 11) => (x << k) | (x >> (32 - k))
-        // discard lower 8 bits (exponent), convert to double in 0..2, map to -1..1:
-        // exactly quivalent to ldexpf((t_sample)(result >> 8), -23) - 1.0;
+	// advances every lane once, writing GENLIB_NOISE_LANES samples:
+	GENLIB_NOISE_STEP void step(t_sample * out) {
+		// discard lower 8 bits (exponent), convert to double in 0..2, map to -1..1:
+		// exactly quivalent to ldexpf((t_sample)(result >> 8), -23) - 1.0;
 		// but much cheaper on ARM CPU
-		static const t_sample EXP2_NEG23 = exp2f(-23.f);
-		return ((result >> 8)*EXP2_NEG23) - 1.f; 
+		// (result >> 8 fits in an int32, and int to float conversions vectorize where unsigned ones do not)
+		const t_sample EXP2_NEG23 = 1.f/8388608.f;
+		// results are gathered locally first, so the compiler need not fear that out aliases the state
+		t_sample result_lanes[GENLIB_NOISE_LANES];
+		for (int l=0; l<GENLIB_NOISE_LANES; l++) {
+			uint32_t s0 = state[0][l], s1 = state[1][l], s2 = state[2][l], s3 = state[3][l];
+			const uint32_t result = s0 + s3;
+			const uint32_t t = s1 << 9;
+			s2 ^= s0;
+			s3 ^= s1;
+			s1 ^= s2;
+			s0 ^= s3;
+			s2 ^= t;
+			s3 = (s3 << 11) | (s3 >> 21); // rotl(s[3], 11) => (x << k) | (x >> (32 - k))
+			state[0][l] = s0; state[1][l] = s1; state[2][l] = s2; state[3][l] = s3;
+			result_lanes[l] = ((int32_t)(result >> 8)*EXP2_NEG23) - 1.f;
+		}
+		for (int l=0; l<GENLIB_NOISE_LANES; l++) out[l] = result_lanes[l];
+	}
+
+	inline t_sample operator()() {
+		if (index >= GENLIB_NOISE_LANES) {
+			step(buffer);
+			index = 0;
+		}
+		return buffer[index++];
+	}
+
+	// fills a block with noise, continuing the same sequence as operator():
+	void fill(t_sample * out, long n) {
+		while (n > 0 && index < GENLIB_NOISE_LANES) {
+			*out++ = buffer[index++];
+			n--;
+		}
+		// whole steps go straight to the output:
+		for (; n >= GENLIB_NOISE_LANES; n -= GENLIB_NOISE_LANES, out += GENLIB_NOISE_LANES) step(out);
+		while (n-- > 0) *out++ = operator()();
 	}
 	
     // splitmix32 suggested by David Blackman and Sebastiano Vigna as a good seed for xoshiro256+:
@@ -864,9 +1239,15 @@ struct Noise {
 	// uses system clock to generate a random seed
 	// ensures distinct seeds even if creating several Noise objects at the same clock value
 	static uint64_t uniqueTickCount(void) {
+	#ifdef OOPSY_TARGET_HOST
+		// host renders must be repeatable, and run on several threads at once,
+		// so genlib_ticks() is a counter per render there
+		return genlib_ticks();
+	#else
 		static uint64_t lasttime = 0;
 		uint64_t time = genlib_ticks();
 		return (time <= lasttime) ? (++lasttime) : (lasttime = time);
+	#endif
 	}
     
     Noise() { reset(); }
@@ -899,6 +1280,10 @@ struct Noise {
 		static const t_sample EXP2_NEG52 = exp2(-52);
 		return ((result >> 11)*EXP2_NEG52) - 1.0; 
 	}
+
+	void fill(t_sample * out, long n) {
+		while (n-- > 0) *out++ = operator()();
+	}
 	
     // splitmix64 suggested by David Blackman and Sebastiano Vigna as a good seed for xoshiro256+:
 	/* This is a fixed-increment version of Java 8's SplittableRandom generator
@@ -915,9 +1300,9 @@ struct Noise {
 };
 #endif
 
-struct Phasor {
+struct PhasorFloat {
 	t_sample phase;
-	Phasor() { reset(); }
+	PhasorFloat() { reset(); }
 	void reset(t_sample v=0.) { phase=v; }
 	inline t_sample operator()(t_sample freq, t_sample invsamplerate) {
 		const t_sample pincr = freq * invsamplerate;
@@ -925,8 +1310,82 @@ struct Phasor {
 		phase = wrap(phase + pincr, 0., 1.);
 		return phase;
 	}
+
+	// fills out with n samples of the ramp, at a constant frequency, or a frequency per sample:
+	void fill(t_sample * out, long n, t_sample freq, t_sample invsamplerate) {
+		for (long i=0; i<n; i++) out[i] = operator()(freq, invsamplerate);
+	}
+	void fill(t_sample * out, long n, const t_sample * freqs, t_sample invsamplerate) {
+		for (long i=0; i<n; i++) out[i] = operator()(freqs[i], invsamplerate);
+	}
 };
 
+// Phasor with a 32-bit fixed-point phase, as SineCycle has.
+// The phase wraps exactly by integer overflow, with no floor or branches, so that it does not drift at low frequencies in float32.
+// The increment is computed in double, so that it is exact to 2^-32 of the samplerate for any float32 frequency
+// (in float32 it would only have 24 significant bits, coarser than 2^-32 above samplerate/256).
+struct PhasorFixed {
+	uint32_t phasei;
+	t_sample phase; // the last output, as in PhasorFloat
+
+	PhasorFixed() { reset(); }
+	void reset(t_sample v=0.) {
+		phase = wrap(v, 0., 1.);
+		phasei = uint32_t(int64_t(phase * t_sample(4294967296.0)));
+	}
+
+	// the phase increment for a frequency, wrapped to 0..1 (negative frequencies wrap backwards):
+	static inline uint32_t increment(t_sample freq, t_sample invsamplerate) {
+		return uint32_t(int64_t(double(freq) * double(invsamplerate) * 4294967296.0));
+	}
+
+	// the top 24 bits are exact in a float, and stay below 1:
+	static inline t_sample output(uint32_t p) {
+		return t_sample(int32_t(p >> 8)) * t_sample(5.9604644775390625e-8);
+	}
+
+	inline t_sample operator()(t_sample freq, t_sample invsamplerate) {
+		phasei += increment(freq, invsamplerate);
+		phase = output(phasei);
+		return phase;
+	}
+
+	// fills out with n samples of the ramp, at a constant frequency:
+	void fill(t_sample * out, long n, t_sample freq, t_sample invsamplerate) {
+		const uint32_t pincr = increment(freq, invsamplerate);
+		// the phase is a simple induction variable, so that this loop can vectorize:
+		uint32_t p = phasei;
+		for (long i=0; i<n; i++) {
+			p += pincr;
+			out[i] = output(p);
+		}
+		phasei = p;
+		if (n > 0) phase = out[n-1];
+	}
+
+	// or with a frequency per sample:
+	void fill(t_sample * out, long n, const t_sample * freqs, t_sample invsamplerate) {
+		// increments and outputs can vectorize, only the running sum in between cannot:
+		uint32_t incrs[64];
+		uint32_t p = phasei;
+		for (long start=0; start<n; start += 64) {
+			const long count = (n - start < 64) ? n - start : 64;
+			for (long i=0; i<count; i++) incrs[i] = increment(freqs[start + i], invsamplerate);
+			for (long i=0; i<count; i++) incrs[i] = (p += incrs[i]);
+			for (long i=0; i<count; i++) out[start + i] = output(incrs[i]);
+		}
+		phasei = p;
+		if (n > 0) phase = out[n-1];
+	}
+};
+
+// gen~ code uses Phasor, which is the fixed-point version with GENLIB_FIXED_PHASOR:
+#ifdef GENLIB_FIXED_PHASOR
+typedef PhasorFixed Phasor;
+#else
+typedef PhasorFloat Phasor;
+#endif
+
 struct PlusEquals {
 	t_sample count;
 	PlusEquals() { reset(); }
@@ -951,6 +1410,30 @@ struct PlusEquals {
 		count = reset ? min+incr : count+incr;
 		return count;
 	}
+
+	// block versions, with an increment and reset per sample (resets may be 0, for none):
+	void post(t_sample * out, long n, const t_sample * incr, const t_sample * resets, t_sample min, t_sample max) {
+		t_sample c = count;
+		for (long i=0; i<n; i++) out[i] = c = (resets && resets[i]) ? min : wrap(c+incr[i], min, max);
+		count = c;
+	}
+	void post(t_sample * out, long n, const t_sample * incr, const t_sample * resets=0, t_sample min=0.) {
+		t_sample c = count;
+		GENLIB_UNROLL4
+		for (long i=0; i<n; i++) out[i] = c = (resets && resets[i]) ? min : c+incr[i];
+		count = c;
+	}
+	void pre(t_sample * out, long n, const t_sample * incr, const t_sample * resets, t_sample min, t_sample max) {
+		t_sample c = count;
+		for (long i=0; i<n; i++) out[i] = c = (resets && resets[i]) ? min+incr[i] : wrap(c+incr[i], min, max);
+		count = c;
+	}
+	void pre(t_sample * out, long n, const t_sample * incr, const t_sample * resets=0, t_sample min=0.) {
+		t_sample c = count;
+		GENLIB_UNROLL4
+		for (long i=0; i<n; i++) out[i] = c = (resets && resets[i]) ? min+incr[i] : c+incr[i];
+		count = c;
+	}
 };
 
 struct MulEquals {
@@ -993,6 +1476,20 @@ struct Sah {
 		prev = trig;
 		return output;
 	}
+
+	// block version: the held output is carried as a select rather than a branch:
+	void process(t_sample * out, long n, const t_sample * in, const t_sample * trig, t_sample thresh) {
+		t_sample p = prev, o = output;
+		GENLIB_UNROLL4
+		for (long i=0; i<n; i++) {
+			const t_sample t = trig[i];
+			o = (p <= thresh && t > thresh) ? in[i] : o;
+			p = t;
+			out[i] = o;
+		}
+		prev = p;
+		output = o;
+	}
 };
 
 struct Train {
@@ -1026,16 +1523,123 @@ struct Train {
 	}
 };
 
+// Band-limited interpolation, for Delay::read_sinc() and DataInterface::read_sinc():
+// a Kaiser-windowed sinc kernel of GENLIB_SINC_TAPS taps, tabulated at GENLIB_SINC_PHASES fractional positions 
+// (and interpolated linearly between them), shared by every reader, 
+// and generated at compile time as const data (i.e. into flash). The default 16 taps x 128 phases is 8KB.
+#ifndef GENLIB_SINC_TAPS
+#define GENLIB_SINC_TAPS (16)
+#endif
+#ifndef GENLIB_SINC_PHASES
+#define GENLIB_SINC_PHASES (128)
+#endif
+// the -6dB point, as a fraction of nyquist, and the Kaiser window's beta:
+// together these trade the flatness of the passband against the rejection of images above it
+#ifndef GENLIB_SINC_CUTOFF
+#define GENLIB_SINC_CUTOFF (0.9)
+#endif
+#ifndef GENLIB_SINC_BETA
+#define GENLIB_SINC_BETA (7.)
+#endif
+
+// constexpr (C++14) helpers for generating the table at compile time:
+inline constexpr double genlib_sinc_sqrt(double x) {
+	double y = x > 1. ? x : 1.;
+	for (int i = 0; i < 40; i++) y = 0.5 * (y + x / y);
+	return y;
+}
+
+// modified Bessel function of the first kind, order 0, by its power series:
+inline constexpr double genlib_sinc_bessel0(double x) {
+	double term = 1., sum = 1.;
+	for (int k = 1; k < 40; k++) {
+		term *= (x * x) / (4. * k * k);
+		sum += term;
+	}
+	return sum;
+}
+
+// sin(pi*x)/(pi*x), reduced to |pi*x| <= pi/2 and evaluated with a Taylor series:
+inline constexpr double genlib_sinc_value(double x) {
+	if (x == 0.) return 1.;
+	double r = x - 2. * double(long(x / 2.)); // -2..2
+	if (r > 1.) r -= 2.;
+	if (r < -1.) r += 2.;
+	if (r > 0.5) r = 1. - r;
+	if (r < -0.5) r = -1. - r;
+	const double t = r * 3.14159265358979323846264338327950288;
+	double term = t, sum = t;
+	for (int k = 1; k < 12; k++) {
+		term *= -(t * t) / double((2*k) * (2*k + 1));
+		sum += term;
+	}
+	return sum / (x * 3.14159265358979323846264338327950288);
+}
+
+// row p holds the taps for reading at fraction p/GENLIB_SINC_PHASES past tap GENLIB_SINC_TAPS/2-1;
+// the extra last row (a whole sample past) is for interpolating between rows.
+// Each row is normalized to unity gain at DC, so that the fraction does not modulate the level.
+struct SincTableConst {
+	float data[GENLIB_SINC_PHASES + 1][GENLIB_SINC_TAPS];
+	constexpr SincTableConst() : data{} {
+		const double half = GENLIB_SINC_TAPS / 2;
+		const double inorm = 1. / genlib_sinc_bessel0(GENLIB_SINC_BETA);
+		for (long p = 0; p <= GENLIB_SINC_PHASES; p++) {
+			double row[GENLIB_SINC_TAPS] = {};
+			double sum = 0.;
+			for (long j = 0; j < GENLIB_SINC_TAPS; j++) {
+				const double t = double(j + 1) - half - double(p) / GENLIB_SINC_PHASES;
+				const double u = t / half;
+				const double w = (u*u < 1.) ? genlib_sinc_bessel0(GENLIB_SINC_BETA * genlib_sinc_sqrt(1. - u*u)) * inorm : 0.;
+				row[j] = genlib_sinc_value(GENLIB_SINC_CUTOFF * t) * w;
+				sum += row[j];
+			}
+			for (long j = 0; j < GENLIB_SINC_TAPS; j++) data[p][j] = float(row[j] / sum);
+		}
+	}
+};
+
+// a template only so that the table can be defined in this header (and is only emitted if used):
+template<int TAPS, int PHASES>
+struct SincTableHolder {
+	static constexpr SincTableConst table {};
+};
+template<int TAPS, int PHASES>
+constexpr SincTableConst SincTableHolder<TAPS, PHASES>::table;
+
+// the dot product of GENLIB_SINC_TAPS samples x[] with the kernel at fraction 0 <= a < 1, 
+// in four independent sums, which vectorize (or on the Daisy, pipeline) without reassociating floating point:
+template<typename T>
+inline t_sample genlib_sinc_dot(const T * x, t_sample a) {
+	static_assert(GENLIB_SINC_TAPS % 4 == 0, "GENLIB_SINC_TAPS must be a multiple of 4");
+	const t_sample pa = a * t_sample(GENLIB_SINC_PHASES);
+	const long p = long(pa);
+	const float f = float(pa - t_sample(p));
+	const float * c0 = SincTableHolder<GENLIB_SINC_TAPS, GENLIB_SINC_PHASES>::table.data[p];
+	const float * c1 = c0 + GENLIB_SINC_TAPS;
+	float acc[4] = { 0.f, 0.f, 0.f, 0.f };
+	for (int j = 0; j < GENLIB_SINC_TAPS; j += 4) {
+		for (int k = 0; k < 4; k++) {
+			acc[k] += (c0[j+k] + f * (c1[j+k] - c0[j+k])) * float(x[j+k]);
+		}
+	}
+	return t_sample((acc[0] + acc[1]) + (acc[2] + acc[3]));
+}
+
 struct Delay {
 	t_sample *memory;
 	long size, wrap, maxdelay;
 	long reader, writer;
+	// whether the heads have wrapped since the last reset, 
+	// if not, only memory up to the reader has been written, and needs zeroing on reset:
+	int wrapped;
 
 	t_genlib_data *dataRef;
 
 	Delay() : memory(0) {
 		size = wrap = maxdelay = 0;
 		reader = writer = 0;
+		wrapped = 0;
 		dataRef = 0;
 	}
 	~Delay() {
@@ -1080,14 +1684,18 @@ struct Delay {
 				}
 				memory = info.data;
 				writer = genlib_data_getcursor(dataRef);
+				// the memory may persist from an earlier instance, so the next reset must zero all of it:
+				wrapped = 1;
 			} else {
 				genlib_report_error("failed to acquire data info");
 			}
 
 		} else {
-			// subsequent reset should zero the memory & heads:
-			genlib_set_zero64(memory, size);
+			// subsequent reset should zero the memory & heads
+			// (a short run after a reset can only have written up to the reader):
+			genlib_set_zero64(memory, wrapped ? size : reader+1);
 			writer = 0;
+			wrapped = 0;
 		}
 
 		reader = writer;
@@ -1097,7 +1705,10 @@ struct Delay {
 	// called at bufferloop end, updates read pointer time
 	inline void step() {
 		reader++;
-		if (reader >= size) reader = 0;
+		if (reader >= size) {
+			reader = 0;
+			wrapped = 1;
+		}
 	}
 
 	inline void write(t_sample x) {
@@ -1187,18 +1798,19 @@ struct Delay {
 		return spline_interp(a, w, x, y, z);
 	}
 	
-	// spline requires extra sample of compensation:
+	// spline6 requires extra samples of compensation:
 	inline t_sample read_spline6(t_sample d) {
 		// min 1 sample delay for read before write (r != w)
-		// plus extra 1 sample compensation for 4-point interpolation
-		const t_sample r = t_sample(size + reader) - clamp(d, t_sample(1.) + t_sample(reader != writer), t_sample(maxdelay));
-		long r0 = long(r);
-		long r1 = r1+1;
-		long r2 = r1+2;
-		long r3 = r1+3;
-		long r4 = r1+4;
-		long r5 = r1+5;
-		t_sample a = r - (t_sample)r0;
+		// plus extra 2 samples compensation for 6-point interpolation
+		// (reading around the same point as the 4-point interpolations)
+		const t_sample r = t_sample(size + reader) - clamp(d, t_sample(2.) + t_sample(reader != writer), t_sample(maxdelay));
+		long r0 = long(r) - 1;
+		long r1 = r0+1;
+		long r2 = r0+2;
+		long r3 = r0+3;
+		long r4 = r0+4;
+		long r5 = r0+5;
+		t_sample a = r - (t_sample)r1;
 		t_sample y0 = memory[r0 & wrap];
 		t_sample y1 = memory[r1 & wrap];
 		t_sample y2 = memory[r2 & wrap];
@@ -1207,6 +1819,25 @@ struct Delay {
 		t_sample y5 = memory[r5 & wrap];
 		return spline6_interp(a, y0, y1, y2, y3, y4, y5);
 	}
+
+	// band-limited, with the GENLIB_SINC_TAPS-point windowed sinc kernel, around the same point as the 4-point interpolations
+	// NOTE: shorter delays are clamped to GENLIB_SINC_TAPS/2 + 1 samples (9 with the default 16 taps), 
+	// or one more when reading before writing, where read_cubic only needs 1 (or 2):
+	inline t_sample read_sinc(t_sample d) {
+		// min 1 sample delay for read before write (r != w)
+		// plus compensation for the taps after the read point
+		const t_sample r = t_sample(size + reader) - clamp(d, t_sample(GENLIB_SINC_TAPS/2 + 1) + t_sample(reader != writer), t_sample(maxdelay));
+		long r1 = long(r);
+		t_sample a = r - (t_sample)r1;
+		const long start = (r1 + 2 - GENLIB_SINC_TAPS/2) & wrap;
+		if (start + GENLIB_SINC_TAPS <= size) {
+			return genlib_sinc_dot(memory + start, a);
+		}
+		// the taps straddle the end of the memory:
+		t_sample x[GENLIB_SINC_TAPS];
+		for (long j = 0; j < GENLIB_SINC_TAPS; j++) x[j] = memory[(start + j) & wrap];
+		return genlib_sinc_dot(x, a);
+	}
 };
 
 template<typename T=t_sample>
@@ -1215,26 +1846,37 @@ struct DataInterface {
 	T *mData;
 	void *mDataReference;		// this was t_symbol *mName
 	int modified;
+	// the distance between successive channels, and successive frames, of the interleaved or planar layout:
+	long chanstride, framestride;
+
+	DataInterface() : dim(0), channels(1), mData(0), modified(0), chanstride(1), framestride(1) { mDataReference = 0; }
 
-	DataInterface() : dim(0), channels(1), mData(0), modified(0) { mDataReference = 0; }
+	// to be called whenever dim or channels change:
+	inline void setlayout(bool planar) {
+		chanstride = planar ? dim : 1;
+		framestride = planar ? 1 : channels;
+	}
+	inline long offset(long index, long channel) const {
+		return channel*chanstride + index*framestride;
+	}
 
 	// raw reading/writing/overdubbing (internal use only, no bounds checking)
 	inline t_sample read(long index, long channel=0) const {
-		return mData[channel+index*channels];
+		return mData[offset(index, channel)];
 	}
 	inline void write(T value, long index, long channel=0) {
-		mData[channel+index*channels] = value;
+		mData[offset(index, channel)] = value;
 		modified = 1;
 	}
 	// NO LONGER USED:
 	inline void overdub(T value, long index, long channel=0) {
-		mData[channel+index*channels] += value;
+		mData[offset(index, channel)] += value;
 		modified = 1;
 	}
 
 	// averaging overdub (used by splat)
 	inline void blend(T value, long index, long channel, t_sample alpha) {
-		long offset = channel+index*channels;
+		long offset = this->offset(index, channel);
 		const T old = mData[offset];
 		mData[offset] = old + alpha * (value - old);
 		modified = 1;
@@ -1242,13 +1884,13 @@ struct DataInterface {
 
 	// NO LONGER USED:
 	inline void read_ok(long index, long channel=0, bool ok=1) const {
-		return ok ? mData[channel+index*channels] : T(0);
+		return ok ? mData[offset(index, channel)] : T(0);
 	}
 	inline void write_ok(T value, long index, long channel=0, bool ok=1) {
-		if (ok) mData[channel+index*channels] = value;
+		if (ok) mData[offset(index, channel)] = value;
 	}
 	inline void overdub_ok(T value, long index, long channel=0, bool ok=1) {
-		if (ok) mData[channel+index*channels] += value;
+		if (ok) mData[offset(index, channel)] += value;
 	}
 
 	// Bounds strategies:
@@ -1320,6 +1962,23 @@ struct DataInterface {
 		return mix(v1, v2, alpha);
 	}
 
+	// band-limited read at a fractional index, with the GENLIB_SINC_TAPS-point windowed sinc kernel 
+	// (bounded by wrapping, as cycle() is):
+	inline t_sample read_sinc(t_sample index, long channel=0) const {
+		channel = channel_clamp(channel);
+		long i1 = (long)index;
+		if (index < 0) i1--;
+		const t_sample alpha = index - (t_sample)i1;
+		const long start = i1 + 1 - GENLIB_SINC_TAPS/2;
+		T x[GENLIB_SINC_TAPS];
+		if (start >= 0 && start + GENLIB_SINC_TAPS <= dim) {
+			for (long j = 0; j < GENLIB_SINC_TAPS; j++) x[j] = mData[offset(start + j, channel)];
+		} else {
+			for (long j = 0; j < GENLIB_SINC_TAPS; j++) x[j] = mData[offset(index_wrap(start + j), channel)];
+		}
+		return genlib_sinc_dot(x, alpha);
+	}
+
 	inline T lookup(t_sample signal, long channel=0) const {
 		channel = channel_clamp(channel);
 		t_sample index = signal2index(signal);
@@ -1381,6 +2040,25 @@ struct DataInterface {
 // DATA_MAXIMUM_ELEMENTS * 8 bytes = 256 mb limit
 #define DATA_MAXIMUM_ELEMENTS	(33554432)
 
+// Multichannel [data] is stored interleaved, as in gen~, unless GENLIB_DATA_PLANAR is set (oopsy's planar option),
+// or the [data] is named with a "planar" word (e.g. loops_planar, or loops_planar_wav), in which case each channel
+// is stored contiguously. Generated code reads & writes either through the same methods,
+// but reading one channel of a planar [data] touches only that channel's memory.
+#ifndef GENLIB_DATA_PLANAR
+#define GENLIB_DATA_PLANAR (0)
+#endif
+
+inline bool genlib_data_planar_name(const char * name) {
+	static const char word[] = "planar";
+	for (const char * s = name; *s; s++) {
+		if (s != name && s[-1] != '_') continue;
+		long i = 0;
+		while (word[i] && s[i] == word[i]) i++;
+		if (!word[i] && (s[i] == 0 || s[i] == '_')) return true;
+	}
+	return false;
+}
+
 struct Data : public DataInterface<t_sample> {
 	t_genlib_data * dataRef;	// a pointer to some external source of the data
 
@@ -1403,6 +2081,7 @@ struct Data : public DataInterface<t_sample> {
 				return;
 			}
 		}
+		genlib_data_setplanar(dataRef, c > 1 && (GENLIB_DATA_PLANAR || genlib_data_planar_name(name)));
 		genlib_data_resize(dataRef, s, c);
 		getinfo();
 	}
@@ -1423,6 +2102,7 @@ struct Data : public DataInterface<t_sample> {
 			mData = info.data;
 			dim = info.dim;
 			channels = info.channels;
+			setlayout(info.planar);
 		} else {
 			genlib_report_error("failed to acquire data info");
 		}
@@ -1447,10 +2127,12 @@ struct DataLocal : public DataInterface<t_sample> {
 			s = DATA_MAXIMUM_ELEMENTS/c;
 			genlib_report_message("warning: resizing data to < 256MB");
 		}
+		// new memory is allocated already zeroed, resized memory must be zeroed here:
+		const bool clear = mData != 0;
 		if (mData) {
 			genlib_sysmem_resizeptr(mData, sizeof(t_sample) * s * c);
 		} else {
-			mData = (t_sample *)genlib_sysmem_newptr(sizeof(t_sample) * s * c);
+			mData = (t_sample *)genlib_sysmem_newptrclear(sizeof(t_sample) * s * c);
 		}
 		if (!mData) {
 			genlib_report_error("out of memory");
@@ -1459,8 +2141,9 @@ struct DataLocal : public DataInterface<t_sample> {
 		} else {
 			dim = s;
 			channels = c;
+			setlayout(false);
 		}
-		genlib_set_zero64(mData, dim * channels);
+		if (clear) genlib_set_zero64(mData, dim * channels);
 	}
 
 	// copy from a buffer~
@@ -1519,6 +2202,7 @@ struct Buffer : public DataInterface<float> {
 	void reset(const char *name) {
 		dim = 1;
 		channels = 1;
+		setlayout(false);
 		mData = &mDummy;
 		mDummy = 0.f;
 		mBuf = 0;
@@ -1557,6 +2241,8 @@ struct Buffer : public DataInterface<float> {
 			dim = 1;
 			channels = 1;
 		}
+		// buffer~ samples are always interleaved:
+		setlayout(false);
 	}
 
 	void end() {
@@ -1571,22 +2257,104 @@ struct Buffer : public DataInterface<float> {
 	}
 };
 
-struct SineData : public DataLocal {
-	SineData() : DataLocal() {
-		const int costable_size = 1 << 14;	// 14 bit index (noise floor at around -156 dB)
-		mData = 0;
-		resize(costable_size, 1);
-		for (int i=0; i<dim; i++) {
-			mData[i] = t_sample(cos(i * GENLIB_PI * 2. / (t_sample)(dim)));
+// The cosine table used by cycle is shared by every SineData (of every app),
+// rather than being allocated and computed for each instance.
+// The default 14-bit table (64KB) is computed once into RAM, on first use.
+// A smaller table (e.g. GENLIB_SINETABLE_BITS 9, 2KB) is read with 4-point cubic interpolation instead,
+// which is as accurate as the 14-bit linear table, and is generated at compile time as const data (i.e. into flash).
+#ifndef GENLIB_SINETABLE_BITS
+#define GENLIB_SINETABLE_BITS (14)
+#endif
+#define GENLIB_SINETABLE_SIZE (1 << GENLIB_SINETABLE_BITS)
+#define GENLIB_SINETABLE_CUBIC (GENLIB_SINETABLE_BITS < 14)
+
+// cos(2*pi*i/n) in double precision, as a constexpr (C++14) so that tables can be built at compile time:
+// reduced to the first octant and evaluated with a Taylor series
+inline constexpr double genlib_costable_poly(double x, int odd) {
+	const double x2 = x*x;
+	double term = odd ? x : 1., sum = term;
+	for (int k = 1; k < 12; k++) {
+		term *= -x2 / double((2*k - 1 + odd) * (2*k + odd));
+		sum += term;
+	}
+	return sum;
+}
+
+inline constexpr double genlib_costable_value(long i, long n) {
+	i = ((i % n) + n) % n;
+	const long quadrant = (4*i) / n;
+	long r = 4*i - quadrant*n; // 0..n-1, in units of (pi/2)/n
+	int odd = (quadrant & 1);
+	if (2*r > n) { r = n - r; odd = !odd; }
+	const double v = genlib_costable_poly(r * (3.14159265358979323846264338327950288 / 2.) / double(n), odd);
+	return (quadrant == 0 || quadrant == 3) ? v : -v;
+}
+
+// one guard point before, and two after the table, so that interpolation needs no wrapping:
+#define GENLIB_SINETABLE_GUARD_SIZE (GENLIB_SINETABLE_SIZE + 3)
+
+#if GENLIB_SINETABLE_CUBIC
+struct SineTableConst {
+	float data[GENLIB_SINETABLE_GUARD_SIZE];
+	constexpr SineTableConst() : data{} {
+		for (long i=0; i<GENLIB_SINETABLE_GUARD_SIZE; i++) {
+			data[i] = float(genlib_costable_value(i - 1, GENLIB_SINETABLE_SIZE));
 		}
 	}
+};
 
-	~SineData() {
-		if (mData) genlib_sysmem_freeptr(mData);
-		mData = 0;
+// a template only so that the table can be defined in this header:
+template<int BITS>
+struct SineTableHolder {
+	static constexpr SineTableConst table {};
+};
+template<int BITS>
+constexpr SineTableConst SineTableHolder<BITS>::table;
+
+inline const float * genlib_sinetable() {
+	return SineTableHolder<GENLIB_SINETABLE_BITS>::table.data + 1;
+}
+#else
+struct SineTableRAM {
+	float data[GENLIB_SINETABLE_GUARD_SIZE];
+	SineTableRAM() {
+		for (long i=0; i<GENLIB_SINETABLE_GUARD_SIZE; i++) {
+			data[i] = float(genlib_costable_value(i - 1, GENLIB_SINETABLE_SIZE));
+		}
+	}
+};
+
+inline const float * genlib_sinetable() {
+	static SineTableRAM table;
+	return table.data + 1;
+}
+#endif
+
+struct SineData : public DataInterface<float> {
+	SineData() : DataInterface<float>() {
+		// the table is never written through SineData, so casting away const is safe:
+		mData = const_cast<float *>(genlib_sinetable());
+		dim = GENLIB_SINETABLE_SIZE;
 	}
+
+	// the table is shared, so it is not freed
+	~SineData() { mData = 0; }
 };
 
+// cos(2*pi*phasei/2^32) from the shared table, interpolated:
+inline t_sample genlib_sinetable_read(const float * data, uint32_t phasei) {
+	// divide uint32_t range down to table size
+	const uint32_t idx = phasei >> (32 - GENLIB_SINETABLE_BITS);
+	// fractional portion, divided by the range of the remaining bits
+	const t_sample frac = t_sample(phasei & ((1u << (32 - GENLIB_SINETABLE_BITS)) - 1)) * t_sample(1. / (1u << (32 - GENLIB_SINETABLE_BITS)));
+	// the guard points make data[idx-1] .. data[idx+2] always safe to read:
+#if GENLIB_SINETABLE_CUBIC
+	return cubic_interp(frac, data[int(idx)-1], data[idx], data[idx+1], data[idx+2]);
+#else
+	return linear_interp(frac, data[idx], data[idx+1]);
+#endif
+}
+
 template<typename T>
 inline int dim(const T& data) { return data.dim; }
 
@@ -1631,7 +2399,285 @@ struct SineCycle {
 		phasei += pincr;
 		return y;
 	}
+
+	// the shared sine table:
+	inline t_sample operator()(const SineData& buf) {
+		const t_sample y = genlib_sinetable_read(buf.mData, phasei);
+		phasei += pincr;
+		return y;
+	}
+};
+
+// cos(2*pi*phasei/2^32) as a polynomial, without any table lookups, 
+// for where gathering from a table would stop a loop vectorizing
+inline t_sample genlib_cos_phase(uint32_t phasei) {
+	// phase as -0.5..0.5 cycles:
+	const t_sample x = t_sample(int32_t(phasei)) * t_sample(0.232830643653869629e-9);
+	// cos(2*pi*x) = sin(2*pi*(0.25 - |x|)):
+	return genlib_sin2pi_poly(float(t_sample(0.25) - (x < 0 ? -x : x)));
+}
+
+// Where the Daisy has no SIMD to vectorize the polynomial over, the table is cheaper:
+#ifndef GENLIB_SINEBANK_POLY
+#if defined(__arm__)
+#define GENLIB_SINEBANK_POLY (0)
+#else
+#define GENLIB_SINEBANK_POLY (1)
+#endif
+#endif
+
+// A bank of N cycle oscillators, for additive and FM patches with many partials.
+// Each oscillator has its own phase accumulator, as SineCycle does, but they all advance together:
+// operator() computes one sample of every oscillator, 
+// and mix() sums a whole block of every oscillator (each scaled by a gain) into an output.
+template<int N>
+struct SineCycleBank {
+
+	uint32_t phasei[N], pincr[N];
+	t_sample f2i;
+
+	void reset(t_sample samplerate, t_sample init = 0) {
+		for (int i=0; i<N; i++) {
+			phasei[i] = uint32_t(init * t_sample(4294967296.0));
+			pincr[i] = 0;
+		}
+		f2i = t_sample(4294967296.0) / samplerate;
+	}
+
+	inline void freq(int i, t_sample f) {
+		pincr[i] = uint32_t(f * f2i);
+	}
+
+	inline void phase(int i, t_sample f) {
+		phasei[i] = uint32_t(f * t_sample(4294967296.0));
+	}
+
+	inline t_sample phase(int i) const {
+		return t_sample(phasei[i] * t_sample(0.232830643653869629e-9));
+	}
+
+	inline t_sample read(const float * data, uint32_t p) const {
+	#if GENLIB_SINEBANK_POLY
+		return genlib_cos_phase(p);
+	#else
+		return genlib_sinetable_read(data, p);
+	#endif
+	}
+
+	// writes the next sample of each oscillator to out[0] .. out[N-1]:
+	inline void operator()(const SineData& buf, t_sample * out) {
+		const float * data = buf.mData;
+		// results are gathered locally first, so the compiler need not fear that out aliases the phases
+		t_sample y[N];
+		for (int i=0; i<N; i++) {
+			const uint32_t p = phasei[i];
+			y[i] = read(data, p);
+			phasei[i] = p + pincr[i];
+		}
+		for (int i=0; i<N; i++) out[i] = y[i];
+	}
+
+	// adds n samples of the oscillators, each scaled by gains[i], to out:
+	void mix(const SineData& buf, const t_sample * gains, t_sample * out, long n) {
+		const float * data = buf.mData;
+		for (int i=0; i<N; i++) {
+			const uint32_t inc = pincr[i];
+			const t_sample g = gains[i];
+			// the phase is a simple induction variable, so the loop over the block can vectorize:
+			uint32_t p = phasei[i];
+			for (long s=0; s<n; s++) {
+				out[s] += g * read(data, p);
+				p += inc;
+			}
+			phasei[i] = p;
+		}
+	}
+};
+
+// Halfband lowpass filters, for resampling by a factor of 2 (used by oopsy to run gen~ at 2x, 4x or half the rate).
+// A halfband filter's taps are zero at every even offset from the centre, except for the centre tap of 0.5,
+// so as a polyphase filter one phase is a plain delay, and only the other (odd) phase needs multiplies.
+// That phase is a Kaiser-windowed sinc of GENLIB_HALFBAND_TAPS taps, symmetric, so each pair shares a multiply.
+// With 16 taps, the response is flat (within 0.2dB) up to 0.8 of the lower rate's Nyquist frequency,
+// and rejects images & aliases from 1.4 times that Nyquist frequency by more than 75dB.
+#ifndef GENLIB_HALFBAND_TAPS
+#define GENLIB_HALFBAND_TAPS (16)
+#endif
+#ifndef GENLIB_HALFBAND_BETA
+#define GENLIB_HALFBAND_BETA (8.)
+#endif
+
+// the odd phase, computed at compile time, normalized to unity gain at DC:
+template<int TAPS>
+struct HalfbandTableConst {
+	float data[TAPS];
+	constexpr HalfbandTableConst() : data{} {
+		const double inorm = 1. / genlib_sinc_bessel0(GENLIB_HALFBAND_BETA);
+		double row[TAPS] = {};
+		double sum = 0.;
+		for (long j = 0; j < TAPS; j++) {
+			// odd offsets from the centre, at the higher rate:
+			const double t = double(2*j + 1 - TAPS);
+			const double u = t / (TAPS + 1);
+			const double w = genlib_sinc_bessel0(GENLIB_HALFBAND_BETA * genlib_sinc_sqrt(1. - u*u)) * inorm;
+			row[j] = genlib_sinc_value(0.5 * t) * w;
+			sum += row[j];
+		}
+		for (long j = 0; j < TAPS; j++) data[j] = float(row[j] / sum);
+	}
+};
+
+template<int TAPS>
+struct HalfbandTableHolder {
+	static constexpr HalfbandTableConst<TAPS> table {};
+};
+template<int TAPS>
+constexpr HalfbandTableConst<TAPS> HalfbandTableHolder<TAPS>::table;
+
+// the odd phase applied to TAPS samples h[] (oldest first), i.e. the value halfway between h[TAPS/2-1] and h[TAPS/2]:
+template<int TAPS>
+inline t_sample genlib_halfband_dot(const t_sample * h) {
+	const float * c = HalfbandTableHolder<TAPS>::table.data;
+	t_sample acc0 = 0, acc1 = 0;
+	for (int j = 0; j < TAPS/2; j += 2) {
+		acc0 += c[j] * (h[j] + h[TAPS-1-j]);
+		acc1 += c[j+1] * (h[j+1] + h[TAPS-2-j]);
+	}
+	return acc0 + acc1;
+}
+
+// Like the other operators, these have no constructors (so that oopsy's apps can share memory in a union);
+// call reset() before use.
+
+// doubles the rate: each input gives two outputs, delayed by TAPS/2 - 1 inputs
+template<int TAPS=GENLIB_HALFBAND_TAPS>
+struct HalfbandUp {
+	// each input is written twice, so that the last TAPS inputs are always contiguous:
+	t_sample history[2*TAPS];
+	long pos;
+
+	void reset() {
+		for (long i=0; i<2*TAPS; i++) history[i] = 0;
+		pos = 0;
+	}
+
+	// writes 2n samples to out from n samples of in:
+	void process(const t_sample * in, t_sample * out, long n) {
+		for (long i=0; i<n; i++) {
+			history[pos] = history[pos + TAPS] = in[i];
+			if (++pos == TAPS) pos = 0;
+			const t_sample * h = history + pos;
+			out[2*i] = h[TAPS/2 - 1];
+			out[2*i+1] = genlib_halfband_dot<TAPS>(h);
+		}
+	}
+};
+
+// halves the rate: each pair of inputs gives one output
+// (out may be the same as in)
+template<int TAPS=GENLIB_HALFBAND_TAPS>
+struct HalfbandDown {
+	// the odd inputs, through the odd phase, written twice as in HalfbandUp:
+	t_sample history[2*TAPS];
+	// the even inputs, through a plain delay to the centre of the odd phase:
+	t_sample centre[TAPS/2 - 1];
+	long pos, cpos;
+
+	void reset() {
+		for (long i=0; i<2*TAPS; i++) history[i] = 0;
+		for (long i=0; i<TAPS/2 - 1; i++) centre[i] = 0;
+		pos = cpos = 0;
+	}
+
+	// writes n samples to out from 2n samples of in:
+	void process(const t_sample * in, t_sample * out, long n) {
+		for (long i=0; i<n; i++) {
+			const t_sample even = in[2*i], odd = in[2*i+1];
+			history[pos] = history[pos + TAPS] = odd;
+			if (++pos == TAPS) pos = 0;
+			const t_sample c = centre[cpos];
+			centre[cpos] = even;
+			if (++cpos == TAPS/2 - 1) cpos = 0;
+			out[i] = t_sample(0.5) * (c + genlib_halfband_dot<TAPS>(history + pos));
+		}
+	}
+};
+
+// RateIn converts a block of n samples at the hardware rate to FACTOR times that rate (2, 4, or -2 for half),
+// and RateOut converts the other way, writing n samples at the hardware rate.
+// For 4x, the second stage (between 2x and 4x) has a wider transition band, so it needs only half the taps,
+// and tmp must hold 2n samples.
+template<int FACTOR> struct RateIn;
+template<int FACTOR> struct RateOut;
+
+template<> struct RateIn<2> {
+	HalfbandUp<> up;
+	void reset() { up.reset(); }
+	void process(const t_sample * in, t_sample * out, long n, t_sample * tmp) { up.process(in, out, n); }
+};
+
+template<> struct RateIn<4> {
+	HalfbandUp<> up1;
+	HalfbandUp<GENLIB_HALFBAND_TAPS/2> up2;
+	void reset() { up1.reset(); up2.reset(); }
+	void process(const t_sample * in, t_sample * out, long n, t_sample * tmp) {
+		up1.process(in, tmp, n);
+		up2.process(tmp, out, 2*n);
+	}
 };
 
+template<> struct RateIn<-2> {
+	HalfbandDown<> down;
+	void reset() { down.reset(); }
+	// (an odd last sample, only at the end of a host render, is dropped)
+	void process(const t_sample * in, t_sample * out, long n, t_sample * tmp) { down.process(in, out, n/2); }
+};
+
+template<> struct RateOut<2> {
+	HalfbandDown<> down;
+	void reset() { down.reset(); }
+	void process(const t_sample * in, t_sample * out, long n, t_sample * tmp) { down.process(in, out, n); }
+};
+
+template<> struct RateOut<4> {
+	HalfbandDown<> down1;
+	HalfbandDown<GENLIB_HALFBAND_TAPS/2> down2;
+	void reset() { down1.reset(); down2.reset(); }
+	void process(const t_sample * in, t_sample * out, long n, t_sample * tmp) {
+		down2.process(in, tmp, 2*n);
+		down1.process(tmp, out, n);
+	}
+};
+
+template<> struct RateOut<-2> {
+	HalfbandUp<> up;
+	void reset() { up.reset(); }
+	void process(const t_sample * in, t_sample * out, long n, t_sample * tmp) {
+		up.process(in, out, n/2);
+		if (n & 1) out[n-1] = (n > 1) ? out[n-2] : t_sample(0);
+	}
+};
+
+// Control signals (CV streams, gates, values read at the end of a block) are not filtered, but held or picked:
+template<int FACTOR>
+inline void genlib_rate_hold_in(const t_sample * in, t_sample * out, long n) {
+	if (FACTOR > 0) {
+		for (long i=0; i<n*FACTOR; i++) out[i] = in[i/FACTOR];
+	} else {
+		for (long i=0; i<n/2; i++) out[i] = in[2*i+1];
+	}
+}
+
+template<int FACTOR>
+inline void genlib_rate_hold_out(const t_sample * in, t_sample * out, long n) {
+	if (FACTOR > 0) {
+		for (long i=0; i<n; i++) out[i] = in[i*FACTOR + FACTOR-1];
+	} else {
+		// (an odd last sample repeats the one before)
+		const long m = n/2;
+		for (long i=0; i<n; i++) out[i] = m ? in[(i/2 < m) ? i/2 : m-1] : t_sample(0);
+	}
+}
+
 #endif
 
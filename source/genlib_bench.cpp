@@ -0,0 +1,404 @@
+/*
+	Micro-benchmarks for the genlib operators, run on the computer
+
+	c++ -std=c++14 -O3 -DGENLIB_USE_FLOAT32 -I gen_dsp genlib_bench.cpp -o genlib_bench && ./genlib_bench
+
+	Times are only a guide to what will be faster on the Daisy (which has no SIMD for floats),
+	but they do show whether an operator is vectorizing/pipelining as intended.
+*/
+#define OOPSY_TARGET_HOST (1)
+// as on the Daisy:
+#ifndef GENLIB_USE_FLOAT32
+#define GENLIB_USE_FLOAT32 (1)
+#endif
+#include "genlib.h"
+#include "genlib_ops.h"
+#include "genlib_exportfunctions.h"
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+unsigned long bench_ticks = 0;
+t_ptr genlib_sysmem_newptr(t_ptr_size size) { return (t_ptr)calloc(1, size); }
+t_ptr genlib_sysmem_newptrclear(t_ptr_size size) { return (t_ptr)calloc(1, size); }
+void genlib_report_error(const char *s) { fprintf(stderr, "%s\n", s); }
+void genlib_report_message(const char *s) { fprintf(stderr, "%s\n", s); }
+unsigned long genlib_ticks() { return ++bench_ticks; }
+#include "genlib_daisy.cpp"
+
+#define BENCH_BLOCK (48)
+#define BENCH_BLOCKS (100000)
+
+t_sample block[BENCH_BLOCK];
+// accumulates every output, so that no benchmark can be optimized away:
+volatile t_sample sink = 0;
+
+// runs fn(block) BENCH_BLOCKS times, and returns the fastest of several runs in ns/sample:
+template<typename F>
+double measure(F fn) {
+	double best = 1e30;
+	for (int run=0; run<5; run++) {
+		auto t0 = std::chrono::steady_clock::now();
+		for (int i=0; i<BENCH_BLOCKS; i++) {
+			fn(block);
+			sink = sink + block[i % BENCH_BLOCK];
+		}
+		auto t1 = std::chrono::steady_clock::now();
+		double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)BENCH_BLOCKS * BENCH_BLOCK);
+		if (ns < best) best = ns;
+	}
+	return best;
+}
+
+template<typename F>
+void bench(const char * name, F fn) {
+	printf("%-32s %8.3f ns/sample\n", name, measure(fn));
+}
+
+// compares a fastmath approximation f(a, b) against the exact function (in double precision), 
+// over inputs (a, b) = input(t) for t in 0..1, 
+// and reports its maximum absolute error, maximum relative error (where |exact| > 1e-3), and ns/call:
+template<typename F, typename E, typename I>
+void accuracy(const char * name, const char * tier, F f, E exact, I input) {
+	double abserr = 0, relerr = 0;
+	const int points = 200000;
+	for (int i=0; i<=points; i++) {
+		float a, b;
+		input(i / double(points), a, b);
+		const double e = exact(double(a), double(b));
+		const double err = fabs(double(f(a, b)) - e);
+		if (!(err <= abserr)) abserr = err; // also catches NaN
+		if (fabs(e) > 1e-3 && !(err/fabs(e) <= relerr)) relerr = err/fabs(e);
+	}
+	float as[BENCH_BLOCK], bs[BENCH_BLOCK];
+	for (int i=0; i<BENCH_BLOCK; i++) input((i + 0.5) / BENCH_BLOCK, as[i], bs[i]);
+	const double ns = measure([&](t_sample * out) {
+		for (int i=0; i<BENCH_BLOCK; i++) out[i] = f(as[i], bs[i]);
+	});
+	printf("%-8s %-8s abs %9.3g   rel %9.3g %8.3f ns/call\n", name, tier, abserr, relerr, ns);
+}
+
+// the single-stream xoshiro128+ that Noise used before it had lanes, as a baseline:
+struct NoiseScalar {
+	uint32_t state[4];
+	NoiseScalar() {
+		Noise seeder(0.5);
+		for (int i=0; i<4; i++) state[i] = seeder.state[i][0];
+	}
+	inline t_sample operator()() {
+		const uint32_t result = state[0] + state[3];
+		const uint32_t t = state[1] << 9;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = (state[3] << 11) | (state[3] >> 21);
+		return ((result >> 8)*exp2f(-23.f)) - 1.f;
+	}
+};
+
+int main(int argc, char ** argv) {
+	printf("%d samples per block, %d noise lanes, %d-bit sine table\n", BENCH_BLOCK, GENLIB_NOISE_LANES, GENLIB_SINETABLE_BITS);
+
+	NoiseScalar scalar;
+	bench("noise (single stream)", [&](t_sample * out) {
+		for (int i=0; i<BENCH_BLOCK; i++) out[i] = scalar();
+	});
+	Noise noise(0.5);
+	bench("noise()", [&](t_sample * out) {
+		for (int i=0; i<BENCH_BLOCK; i++) out[i] = noise();
+	});
+	bench("noise.fill()", [&](t_sample * out) {
+		noise.fill(out, BENCH_BLOCK);
+	});
+
+	SineData sinedata;
+	SineCycle cycle;
+	cycle.reset(48000);
+	cycle.freq(440);
+	bench("cycle", [&](t_sample * out) {
+		for (int i=0; i<BENCH_BLOCK; i++) out[i] = cycle(sinedata);
+	});
+
+	PhasorFloat phasorfloat;
+	PhasorFixed phasorfixed;
+	const t_sample isr = 1.f/48000;
+	bench("phasor (float)", [&](t_sample * out) {
+		for (int i=0; i<BENCH_BLOCK; i++) out[i] = phasorfloat(440, isr);
+	});
+	bench("phasor (fixed)", [&](t_sample * out) {
+		for (int i=0; i<BENCH_BLOCK; i++) out[i] = phasorfixed(440, isr);
+	});
+	bench("phasor (fixed) fill()", [&](t_sample * out) {
+		phasorfixed.fill(out, BENCH_BLOCK, 440, isr);
+	});
+	t_sample freqs[BENCH_BLOCK];
+	for (int i=0; i<BENCH_BLOCK; i++) freqs[i] = 440 + i;
+	bench("phasor (fixed) fill(freqs)", [&](t_sample * out) {
+		phasorfixed.fill(out, BENCH_BLOCK, freqs, isr);
+	});
+
+	// 32 partials of an additive synth, as separate cycles and as a bank:
+	const int partials = 32;
+	SineCycle cycles[partials];
+	SineCycleBank<partials> bank;
+	t_sample gains[partials], lanes[partials];
+	bank.reset(48000);
+	for (int p=0; p<partials; p++) {
+		cycles[p].reset(48000);
+		cycles[p].freq(110 * (p+1));
+		bank.freq(p, 110 * (p+1));
+		gains[p] = 1.f/(p+1);
+	}
+	bench("32 x cycle", [&](t_sample * out) {
+		for (int i=0; i<BENCH_BLOCK; i++) {
+			t_sample sum = 0;
+			for (int p=0; p<partials; p++) sum += gains[p] * cycles[p](sinedata);
+			out[i] = sum;
+		}
+	});
+	bench("SineCycleBank<32>()", [&](t_sample * out) {
+		for (int i=0; i<BENCH_BLOCK; i++) {
+			bank(sinedata, lanes);
+			t_sample sum = 0;
+			for (int p=0; p<partials; p++) sum += gains[p] * lanes[p];
+			out[i] = sum;
+		}
+	});
+	bench("SineCycleBank<32>.mix()", [&](t_sample * out) {
+		for (int i=0; i<BENCH_BLOCK; i++) out[i] = 0;
+		bank.mix(sinedata, gains, out, BENCH_BLOCK);
+	});
+
+	// per-sample operators against their block versions, over a block of inputs:
+	printf("\n");
+	static t_sample inputs[3][BENCH_BLOCK];
+	for (int i=0; i<BENCH_BLOCK; i++) {
+		inputs[0][i] = t_sample(-3.3 + 0.17*i);
+		inputs[1][i] = t_sample(sin(i*0.7));
+		inputs[2][i] = (i == 17);
+	}
+	// the inputs are read through a volatile pointer in each block, 
+	// so that the compiler cannot hoist the work on them out of the benchmark loop:
+	t_sample (* volatile inputs_v)[BENCH_BLOCK] = inputs;
+	// (not every benchmark uses all three)
+	#define BENCH_INPUTS const t_sample * ins = inputs_v[0], * ins2 = inputs_v[1], * resets = inputs_v[2]; (void)ins; (void)ins2; (void)resets;
+	bench("wrap", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = wrap(ins[i], 0, 1); });
+	bench("genlib_block_wrap", [&](t_sample * out) { BENCH_INPUTS genlib_block_wrap(out, BENCH_BLOCK, ins, 0, 1); });
+	bench("fold", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = fold(ins[i], -1, 1); });
+	bench("genlib_block_fold", [&](t_sample * out) { BENCH_INPUTS genlib_block_fold(out, BENCH_BLOCK, ins, -1, 1); });
+	bench("clamp", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = clamp(ins[i], -1, 1); });
+	bench("genlib_block_clamp", [&](t_sample * out) { BENCH_INPUTS genlib_block_clamp(out, BENCH_BLOCK, ins, -1, 1); });
+	bench("mix", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = mix(ins[i], ins2[i], 0.3); });
+	bench("genlib_block_mix", [&](t_sample * out) { BENCH_INPUTS genlib_block_mix(out, BENCH_BLOCK, ins, ins2, 0.3); });
+	bench("scale", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = scale(ins[i], -4, 4, 0, 1, 1); });
+	bench("genlib_block_scale", [&](t_sample * out) { BENCH_INPUTS genlib_block_scale(out, BENCH_BLOCK, ins, -4, 4, 0, 1, 1); });
+	bench("dbtoa", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = dbtoa(ins[i]); });
+	bench("genlib_block_dbtoa", [&](t_sample * out) { BENCH_INPUTS genlib_block_dbtoa(out, BENCH_BLOCK, ins); });
+	bench("mtof", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = mtof(ins[i]); });
+	bench("genlib_block_mtof", [&](t_sample * out) { BENCH_INPUTS genlib_block_mtof(out, BENCH_BLOCK, ins); });
+	bench("triangle", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = triangle(ins[i], 0.3); });
+	bench("genlib_block_triangle", [&](t_sample * out) { BENCH_INPUTS genlib_block_triangle(out, BENCH_BLOCK, ins, 0.3); });
+	Delta delta;
+	bench("delta", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = delta(ins[i]); });
+	bench("delta.process()", [&](t_sample * out) { BENCH_INPUTS delta.process(out, BENCH_BLOCK, ins); });
+	Change change;
+	bench("change", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = change(ins2[i]); });
+	bench("change.process()", [&](t_sample * out) { BENCH_INPUTS change.process(out, BENCH_BLOCK, ins2); });
+	DCBlock dcblock;
+	bench("dcblock", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = dcblock(ins[i]); });
+	bench("dcblock.process()", [&](t_sample * out) { BENCH_INPUTS dcblock.process(out, BENCH_BLOCK, ins); });
+	Sah sah;
+	bench("sah", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = sah(ins[i], ins2[i], 0); });
+	bench("sah.process()", [&](t_sample * out) { BENCH_INPUTS sah.process(out, BENCH_BLOCK, ins, ins2, 0); });
+	PlusEquals accum;
+	bench("+=", [&](t_sample * out) { BENCH_INPUTS for (int i=0; i<BENCH_BLOCK; i++) out[i] = accum.post(ins2[i], resets[i], 0); });
+	bench("+=.post()", [&](t_sample * out) { BENCH_INPUTS accum.post(out, BENCH_BLOCK, ins2, resets, 0); });
+
+	// delay interpolations, against the exact (analytic) delayed sine, as SNR in dB at several frequencies,
+	// reading at a delay sweeping slowly over fractional values:
+	printf("\n%-16s", "delay read SNR");
+	const double sr = 48000, testfreqs[] = { 100, 1000, 5000, 10000, 15000, 18000 };
+	for (double f : testfreqs) printf(" %7.0fHz", f);
+	printf("  ns/sample\n");
+	Delay delay;
+	delay.reset("bench_delay", 4096);
+	auto delayread = [&](const char * name, double offset, std::function<t_sample(t_sample)> read) {
+		printf("%-16s", name);
+		for (double f : testfreqs) {
+			double signal = 0, noise = 0;
+			for (long n = 0; n < 48000; n++) {
+				delay.write(t_sample(sin(2*GENLIB_PI*f*n/sr)));
+				const double d = 100.5 + 50*sin(n*0.001);
+				const t_sample y = read(t_sample(d));
+				if (n > 4096) {
+					const double e = sin(2*GENLIB_PI*f*(n - d + offset)/sr);
+					signal += e*e;
+					noise += (y - e)*(y - e);
+				}
+				delay.step();
+			}
+			printf(" %9.1f", 10*log10(signal/noise));
+		}
+		const t_sample * d = inputs[1];
+		printf(" %10.3f\n", measure([&](t_sample * out) {
+			for (int i=0; i<BENCH_BLOCK; i++) out[i] = read(t_sample(100.5 + d[i]));
+		}));
+	};
+	delayread("linear", 0, [&](t_sample d) { return delay.read_linear(d); });
+	delayread("cubic", 1, [&](t_sample d) { return delay.read_cubic(d); });
+	delayread("spline", 1, [&](t_sample d) { return delay.read_spline(d); });
+	delayread("spline6", 1, [&](t_sample d) { return delay.read_spline6(d); });
+	delayread("sinc", 1, [&](t_sample d) { return delay.read_sinc(d); });
+
+	// reading one channel of a large 8-channel [data], interleaved and planar:
+	printf("\n");
+	const long dataframes = 1 << 20;
+	Data interleaved, planar;
+	interleaved.reset("bench_interleaved", dataframes, 8);
+	planar.reset("bench_planar", dataframes, 8);
+	for (long i=0; i<dataframes; i++) {
+		for (int c=0; c<8; c++) {
+			interleaved.write(t_sample(i + c), i, c);
+			planar.write(t_sample(i + c), i, c);
+		}
+	}
+	long dataindex = 0;
+	bench("data read (interleaved)", [&](t_sample * out) {
+		for (int i=0; i<BENCH_BLOCK; i++) out[i] = interleaved.read((dataindex + i) & (dataframes-1), 3);
+		dataindex += BENCH_BLOCK;
+	});
+	dataindex = 0;
+	bench("data read (planar)", [&](t_sample * out) {
+		for (int i=0; i<BENCH_BLOCK; i++) out[i] = planar.read((dataindex + i) & (dataframes-1), 3);
+		dataindex += BENCH_BLOCK;
+	});
+
+	// resampling one channel into and out of gen~ (per hardware sample), see the oversample options:
+	printf("\n");
+	t_sample ratebuf[4*BENCH_BLOCK], ratetmp[2*BENCH_BLOCK];
+	RateIn<2> in2x; RateOut<2> out2x;
+	RateIn<4> in4x; RateOut<4> out4x;
+	RateIn<-2> inhalf; RateOut<-2> outhalf;
+	in2x.reset(); out2x.reset(); in4x.reset(); out4x.reset(); inhalf.reset(); outhalf.reset();
+	bench("oversample2 in & out", [&](t_sample * out) {
+		BENCH_INPUTS
+		in2x.process(ins, ratebuf, BENCH_BLOCK, ratetmp);
+		out2x.process(ratebuf, out, BENCH_BLOCK, ratetmp);
+	});
+	bench("oversample4 in & out", [&](t_sample * out) {
+		BENCH_INPUTS
+		in4x.process(ins, ratebuf, BENCH_BLOCK, ratetmp);
+		out4x.process(ratebuf, out, BENCH_BLOCK, ratetmp);
+	});
+	bench("undersample2 in & out", [&](t_sample * out) {
+		BENCH_INPUTS
+		inhalf.process(ins, ratebuf, BENCH_BLOCK, ratetmp);
+		outhalf.process(ratebuf, out, BENCH_BLOCK, ratetmp);
+	});
+
+	// the per-block overhead of processing a target's controls, against the block size:
+	// (modelled on libdaisy's AnalogControl and Switch, for 8 knobs & 4 switches, around a trivial perform)
+	printf("\n");
+	struct Knob { t_sample val = 0; } knobs[8];
+	struct Button { uint8_t state = 0; t_sample rise = 0; } buttons[4];
+	for (int size = 1; size <= BENCH_BLOCK; size = (size == 16) ? BENCH_BLOCK : size*2) {
+		// every block, and at about 1kHz:
+		const int divisors[2] = { 1, BENCH_BLOCK/size };
+		for (int d=0; d<(divisors[1] > 1 ? 2 : 1); d++) {
+			const int divisor = divisors[d];
+			char name[64];
+			snprintf(name, sizeof(name), "block%d controls, divisor %d", size, divisor);
+			int count = 0;
+			bench(name, [&](t_sample * out) {
+				BENCH_INPUTS
+				for (int b=0; b<BENCH_BLOCK; b += size) {
+					if (count++ % divisor == 0) {
+						for (int k=0; k<8; k++) knobs[k].val += t_sample(0.002) * (ins2[k] - knobs[k].val);
+						for (int k=0; k<4; k++) {
+							buttons[k].state = (buttons[k].state << 1) | (resets[k+16] > 0);
+							buttons[k].rise = buttons[k].state == 0x7f;
+						}
+					}
+					for (int i=b; i<b+size; i++) out[i] = ins[i]*knobs[0].val + buttons[0].rise;
+				}
+			});
+		}
+	}
+
+	// fastmath tiers, over typical ranges:
+	printf("\n");
+	auto angle = [](double t, float& a, float& b) { a = float(-10 + 20*t); b = 0; };
+	accuracy("sin", "exact", [](float a, float b) { return sinf(a); }, [](double a, double b) { return sin(a); }, angle);
+	accuracy("sin", "fast", [](float a, float b) { return genlib_fastsinfull(a); }, [](double a, double b) { return sin(a); }, angle);
+	accuracy("sin", "faster", [](float a, float b) { return genlib_fastersinfull(a); }, [](double a, double b) { return sin(a); }, angle);
+	accuracy("cos", "exact", [](float a, float b) { return cosf(a); }, [](double a, double b) { return cos(a); }, angle);
+	accuracy("cos", "fast", [](float a, float b) { return genlib_fastcosfull(a); }, [](double a, double b) { return cos(a); }, angle);
+	accuracy("cos", "faster", [](float a, float b) { return genlib_fastercosfull(a); }, [](double a, double b) { return cos(a); }, angle);
+	auto tanangle = [](double t, float& a, float& b) { a = float(-1.5 + 3*t); b = 0; };
+	accuracy("tan", "exact", [](float a, float b) { return tanf(a); }, [](double a, double b) { return tan(a); }, tanangle);
+	accuracy("tan", "fast", [](float a, float b) { return genlib_fasttanfull(a); }, [](double a, double b) { return tan(a); }, tanangle);
+	accuracy("tan", "faster", [](float a, float b) { return genlib_fastertanfull(a); }, [](double a, double b) { return tan(a); }, tanangle);
+	// e.g. mtof over the MIDI range:
+	auto exparg = [](double t, float& a, float& b) { a = float(-4 + 8*t); b = 0; };
+	accuracy("exp", "exact", [](float a, float b) { return expf(a); }, [](double a, double b) { return exp(a); }, exparg);
+	accuracy("exp", "fast", [](float a, float b) { return genlib_fastexp(a); }, [](double a, double b) { return exp(a); }, exparg);
+	accuracy("exp", "faster", [](float a, float b) { return genlib_fasterexp(a); }, [](double a, double b) { return exp(a); }, exparg);
+	auto logarg = [](double t, float& a, float& b) { a = float(pow(10., -3 + 6*t)); b = 0; };
+	accuracy("log2", "exact", [](float a, float b) { return log2f(a); }, [](double a, double b) { return log2(a); }, logarg);
+	accuracy("log2", "fast", [](float a, float b) { return genlib_fastlog2(a); }, [](double a, double b) { return log2(a); }, logarg);
+	accuracy("log2", "faster", [](float a, float b) { return genlib_fasterlog2(a); }, [](double a, double b) { return log2(a); }, logarg);
+	auto powarg = [](double t, float& a, float& b) { a = float(0.01 + 10*t); b = float(-2 + 4*fmod(t*37, 1.)); };
+	accuracy("pow", "exact", [](float a, float b) { return powf(a, b); }, [](double a, double b) { return pow(a, b); }, powarg);
+	accuracy("pow", "fast", [](float a, float b) { return genlib_fastpow(a, b); }, [](double a, double b) { return pow(a, b); }, powarg);
+	accuracy("pow", "faster", [](float a, float b) { return genlib_fasterpow(a, b); }, [](double a, double b) { return pow(a, b); }, powarg);
+	auto atanarg = [](double t, float& a, float& b) { a = float(sin(t*2*GENLIB_PI)*(1 + 9*t)); b = float(cos(t*2*GENLIB_PI)*(1 + 9*t)); };
+	accuracy("atan2", "exact", [](float a, float b) { return atan2f(a, b); }, [](double a, double b) { return atan2(a, b); }, atanarg);
+	accuracy("atan2", "fast", [](float a, float b) { return genlib_fastatan2(a, b); }, [](double a, double b) { return atan2(a, b); }, atanarg);
+	accuracy("atan2", "faster", [](float a, float b) { return genlib_fasteratan2(a, b); }, [](double a, double b) { return atan2(a, b); }, atanarg);
+	auto tanharg = [](double t, float& a, float& b) { a = float(-10 + 20*t); b = 0; };
+	accuracy("tanh", "exact", [](float a, float b) { return tanhf(a); }, [](double a, double b) { return tanh(a); }, tanharg);
+	accuracy("tanh", "fast", [](float a, float b) { return genlib_fasttanh(a); }, [](double a, double b) { return tanh(a); }, tanharg);
+	accuracy("tanh", "faster", [](float a, float b) { return genlib_fastertanh(a); }, [](double a, double b) { return tanh(a); }, tanharg);
+
+	// a bank of feedback paths decaying towards silence, as in a reverb tail, 
+	// with the states near the bottom of the normal float range, or already denormal:
+	printf("\n");
+	const int paths = 32;
+	t_sample states[paths];
+	auto feedback = [&](t_sample start, bool fix) {
+		return measure([&](t_sample * out) {
+			for (int p=0; p<paths; p++) states[p] = start;
+			for (int i=0; i<BENCH_BLOCK; i++) {
+				t_sample sum = 0;
+				for (int p=0; p<paths; p++) {
+					states[p] = states[p] * t_sample(0.9999);
+					if (fix) states[p] = fixdenorm(states[p]);
+					sum += states[p];
+				}
+				out[i] = sum;
+			}
+		});
+	};
+	const double normal = feedback(1e-30f, false);
+	printf("%-32s %8.3f ns/sample\n", "feedback tail (normal)", normal);
+	const double fixed = feedback(1e-39f, true);
+	const double denormal = feedback(1e-39f, false);
+	// (this sets the FPU mode for the rest of the process, so it comes last)
+	genlib_flush_denormals();
+	const double flushed = feedback(1e-39f, false);
+	printf("%-32s %8.3f ns/sample\n", "feedback tail (fixdenorm)", fixed);
+	printf("%-32s %8.3f ns/sample (%.1fx normal)\n", "feedback tail (denormal)", denormal, denormal/normal);
+	printf("%-32s %8.3f ns/sample (%.1fx normal)\n", "feedback tail (flushed)", flushed, flushed/normal);
+	for (int p=0; p<paths; p++) {
+		if (states[p] != 0) {
+			printf("error: denormals were not flushed\n");
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -33,22 +33,35 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <malloc.h>
 #define malloc_size malloc_usable_size
 
+// the profile hooks are defined by genlib_daisy.h & genlib_host.h, but not for e.g. genlib_bench.cpp:
+#ifndef OOPSY_PROFILE_START
+#define OOPSY_PROFILE_START(var)
+#define OOPSY_PROFILE_ADD(name, var)
+#endif
+
 // DATA_MAXIMUM_ELEMENTS * 8 bytes = 256 mb limit
 #define DATA_MAXIMUM_ELEMENTS	(33554432)
 
 t_ptr genlib_sysmem_resizeptr(void *ptr, t_ptr_size newsize) {
-	// this function only seems to get called by SineData if reset() happens a second time
+	// this function only seems to get called by DataLocal if reset() happens a second time
 	// this shouldn't ever happen, so we default to new allocation:
 	return genlib_sysmem_newptr(newsize);
 }
 
 void genlib_sysmem_freeptr(void *ptr) {
+	#ifdef OOPSY_TARGET_HOST
+	// host renders allocate with calloc, and run many apps one after another
+	free(ptr);
+	#else
 	// nothing to do, we are not running memory management here
+	#endif
 }
 
+// (zero bits are 0. in IEEE floating point, and memset is much faster than a loop of stores)
 void genlib_set_zero64(t_sample *memory, long size) {
-	long i;
-	for (i = 0; i < size; i++, memory++) *memory = 0.;
+	OOPSY_PROFILE_START(start);
+	memset(memory, 0, sizeof(t_sample) * size);
+	OOPSY_PROFILE_ADD("zero memory", start);
 }
 
 // NEED THIS FOR WINDOWS:
@@ -112,6 +125,7 @@ t_genlib_data *genlib_obtain_data_from_reference(void *ref) {
 	self->info.dim = 0;
 	self->info.channels = 0;
 	self->info.data = 0;
+	self->info.planar = 0;
 	self->cursor = 0;
 	return (t_genlib_data *)self;
 }
@@ -121,6 +135,7 @@ t_genlib_err genlib_data_getinfo(t_genlib_data *b, t_genlib_data_info *info) {
 	info->dim = self->info.dim;
 	info->channels = self->info.channels;
 	info->data = self->info.data;
+	info->planar = self->info.planar;
 	return GENLIB_ERR_NONE;
 }
 
@@ -142,6 +157,12 @@ void genlib_data_setcursor(t_genlib_data *b, long cursor) {
 	self->cursor = t_sample(cursor);
 }
 
+// the layout must be chosen before the data is first sized, as resizing keeps the contents in the same layout:
+void genlib_data_setplanar(t_genlib_data *b, int planar) {
+	t_dsp_gen_data *self = (t_dsp_gen_data *)b;
+	if (self->info.data == 0) self->info.planar = planar;
+}
+
 void genlib_data_resize(t_genlib_data *b, long s, long c) {
 	t_dsp_gen_data *self = (t_dsp_gen_data *)b;
 
@@ -182,8 +203,9 @@ void genlib_data_resize(t_genlib_data *b, long s, long c) {
 
 	} else {
 
-		// allocate new:
-		replaced = (t_sample *)genlib_sysmem_newptr(sz);
+		// allocate new, zeroed 
+		// (on the Daisy, only memory that may be dirty is cleared; see oopsy::allocate):
+		replaced = (t_sample *)genlib_sysmem_newptrclear(sz);
 
 		// check allocation:
 		if (replaced == 0) {
@@ -198,16 +220,19 @@ void genlib_data_resize(t_genlib_data *b, long s, long c) {
 			return;
 		}
 
-		// fill with zeroes:
-		genlib_set_zero64(replaced, s * c);
-
 		// copy in old data:
 		if (old) {
 			// frames to copy:
 			// clamped:
 			copydim = olddim > s ? s : olddim;
-			// use memcpy if channels haven't changed:
-			if (c == oldchannels) {
+			if (self->info.planar) {
+				// each channel is a contiguous block, which moves if the dim changed:
+				copychannels = oldchannels > c ? c : oldchannels;
+				for (j = 0; j < copychannels; j++) {
+					memcpy(replaced + j * s, old + j * olddim, sizeof(t_sample) * copydim);
+				}
+			} else if (c == oldchannels) {
+				// use memcpy if channels haven't changed:
 				copysz = sizeof(t_sample) * copydim * c;
 				//post("reset resize (same channels) %p %p, %d", self->info.data, old, copysz);
 				memcpy(replaced, old, copysz);
@@ -267,15 +292,67 @@ void genlib_data_resize(t_genlib_data *b, long s, long c) {
 
 void genlib_reset_complete(void *data) {}
 
+// a state snapshot is a small header followed by one float per float param, in param index order
+// (params of other types, such as [data] names, are not included)
+#define GENLIB_STATE_MAGIC (0x74736e67) // "gnst"
+
+typedef struct {
+	uint32_t magic;
+	uint32_t numparams;
+} t_genlib_state_header;
+
+static uint32_t genlib_state_numparams(CommonState *cself) {
+	uint32_t n = 0;
+	for (long i = 0; i < cself->numparams; i++) {
+		if (cself->params[i].paramtype == GENLIB_PARAMTYPE_FLOAT) n++;
+	}
+	return n;
+}
+
 size_t genlib_getstatesize(CommonState *cself, getparameter_method getmethod) {
-	return 0;
+	return sizeof(t_genlib_state_header) + sizeof(float) * genlib_state_numparams(cself);
 }
 
 short genlib_getstate(CommonState *cself, char *state, getparameter_method getmethod) {
+	t_genlib_state_header *header = (t_genlib_state_header *)state;
+	float *values = (float *)(state + sizeof(t_genlib_state_header));
+	header->magic = GENLIB_STATE_MAGIC;
+	header->numparams = genlib_state_numparams(cself);
+	for (long i = 0; i < cself->numparams; i++) {
+		if (cself->params[i].paramtype != GENLIB_PARAMTYPE_FLOAT) continue;
+		t_param value = 0;
+		getmethod(cself, i, &value);
+		*values++ = float(value);
+	}
 	return 0;
 }
 
 short genlib_setstate(CommonState *cself, const char *state, setparameter_method setmethod) {
+	const t_genlib_state_header *header = (const t_genlib_state_header *)state;
+	const float *values = (const float *)(state + sizeof(t_genlib_state_header));
+	// refuse snapshots taken from a different patcher:
+	if (header->magic != GENLIB_STATE_MAGIC || header->numparams != genlib_state_numparams(cself)) return 1;
+	for (long i = 0; i < cself->numparams; i++) {
+		if (cself->params[i].paramtype != GENLIB_PARAMTYPE_FLOAT) continue;
+		setmethod(cself, i, t_param(*values++), 0);
+	}
+	return 0;
+}
+
+// sets params to a linear interpolation of two snapshots (mix 0 is state a, mix 1 is state b)
+short genlib_morphstate(CommonState *cself, const char *a, const char *b, t_param mix, setparameter_method setmethod) {
+	const t_genlib_state_header *ha = (const t_genlib_state_header *)a;
+	const t_genlib_state_header *hb = (const t_genlib_state_header *)b;
+	const float *va = (const float *)(a + sizeof(t_genlib_state_header));
+	const float *vb = (const float *)(b + sizeof(t_genlib_state_header));
+	uint32_t n = genlib_state_numparams(cself);
+	if (ha->magic != GENLIB_STATE_MAGIC || hb->magic != GENLIB_STATE_MAGIC || ha->numparams != n || hb->numparams != n) return 1;
+	for (long i = 0; i < cself->numparams; i++) {
+		if (cself->params[i].paramtype != GENLIB_PARAMTYPE_FLOAT) continue;
+		setmethod(cself, i, t_param(*va + mix * (*vb - *va)), 0);
+		va++;
+		vb++;
+	}
 	return 0;
 }
 
@@ -49,15 +49,71 @@ static bool      update = false;
 static const uint32_t OOPSY_SRAM_SIZE = 512 * 1024; 
 static const uint32_t OOPSY_SDRAM_SIZE = 64 * 1024 * 1024;
 
+// With OOPSY_TCM, the audio path runs from ITCM, and gen~ State and small buffers live in DTCM,
+// the Cortex-M7's tightly coupled memories, which have no wait states and never miss a cache.
+// oopsy.js generates oopsy_tcm.ld, which places these sections in the libdaisy linker script's memory regions.
+#ifdef OOPSY_TCM
+#define OOPSY_ITCM __attribute__((section(".oopsy_itcm")))
+// for the generated audio callbacks, so that gen~'s perform (and the operators it uses) are inlined into ITCM too:
+#define OOPSY_ITCM_FLATTEN __attribute__((section(".oopsy_itcm"), flatten))
+#define OOPSY_DTCM __attribute__((section(".oopsy_dtcm")))
+// the rest of DTCM holds the stack:
+#ifndef OOPSY_DTCM_SIZE
+#define OOPSY_DTCM_SIZE (64 * 1024)
+#endif
+// allocations larger than this go to SRAM, leaving DTCM for gen~ State and small delays & data:
+#ifndef OOPSY_DTCM_MAX_ALLOC
+#define OOPSY_DTCM_MAX_ALLOC (OOPSY_DTCM_SIZE / 4)
+#endif
+
+// ITCM code is copied from flash, and DTCM zeroed, before any other static initialization:
+extern "C" {
+	extern char _oopsy_itcm_start[], _oopsy_itcm_end[], _oopsy_itcm_load[];
+	extern char _oopsy_dtcm_start[], _oopsy_dtcm_end[];
+}
+__attribute__((constructor(101))) static void oopsy_tcm_init() {
+	memcpy(_oopsy_itcm_start, _oopsy_itcm_load, _oopsy_itcm_end - _oopsy_itcm_start);
+	memset(_oopsy_dtcm_start, 0, _oopsy_dtcm_end - _oopsy_dtcm_start);
+	__DSB();
+	__ISB();
+}
+#else
+#define OOPSY_ITCM
+#define OOPSY_ITCM_FLATTEN
+#define OOPSY_DTCM
+#endif
+
 // Added dedicated global SDFile to replace old global from libDaisy
 FIL SDFile;
 
+// the scratch arena is small and touched every block, so it goes in DTCM too:
+#define OOPSY_SCRATCH_STORAGE OOPSY_DTCM
+// the profiler's timer starts in System::Init():
+#define OOPSY_PROFILE_NOW() daisy::System::GetUs()
+#include "genlib_oopsy.h"
+
 namespace oopsy {
 
 	uint32_t sram_used = 0, sram_usable = 0;
 	uint32_t sdram_used = 0, sdram_usable = 0;
 	char * sram_pool = nullptr;
 	char DSY_SDRAM_BSS sdram_pool[OOPSY_SDRAM_SIZE];
+	#ifdef OOPSY_TCM
+	uint32_t dtcm_used = 0, dtcm_usable = 0;
+	char OOPSY_DTCM dtcm_pool[OOPSY_DTCM_SIZE] __attribute__((aligned(8)));
+	#endif
+
+	// Successive apps take SDRAM from alternate ends of the pool (sdram_end 0 is the bottom, 1 the top),
+	// so that the memory the previous app used can be cleared in the background (by clear_idle(), from the main loop)
+	// while the next one runs, rather than when it loads.
+	// sdram_dirty[e] is how far from end e the pool may hold non-zero data;
+	// SDRAM is not cleared at power up, so at first all of it may.
+	uint32_t sdram_dirty[2] = { OOPSY_SDRAM_SIZE, 0 };
+	int sdram_end = 1; // flipped by init(), so that the first app allocates from the bottom
+	// how much clear_idle() clears on each call:
+	#ifndef OOPSY_CLEAR_IDLE_BYTES
+	#define OOPSY_CLEAR_IDLE_BYTES (32 * 1024)
+	#endif
 
 	void init() {
 		if (!sram_pool) sram_pool = (char *)malloc(OOPSY_SRAM_SIZE);
@@ -65,27 +121,70 @@ namespace oopsy {
 		sram_used = 0;
 		sdram_usable = OOPSY_SDRAM_SIZE;
 		sdram_used = 0;
+		sdram_end = !sdram_end;
+		#ifdef OOPSY_TCM
+		dtcm_usable = OOPSY_DTCM_SIZE;
+		dtcm_used = 0;
+		#endif
+		scratch_used = OOPSY_SCRATCH_RESERVED;
+	}
+
+	// zeroes the SDRAM from distance `from` up to distance `to` from end e of the pool:
+	void sdram_zero(int e, uint32_t from, uint32_t to) {
+		if (to > from) ::memset(sdram_pool + (e ? OOPSY_SDRAM_SIZE - to : from), 0, to - from);
 	}
 
-	void * allocate(uint32_t size) {
+	// with clear, the memory is zeroed (though only the parts that may be dirty need it):
+	void * allocate(uint32_t size, bool clear=false) {
+		// keep every allocation 8-byte aligned, from either end of the SDRAM:
+		size = (size + 7) & ~7u;
+		#ifdef OOPSY_TCM
+		if (size <= OOPSY_DTCM_MAX_ALLOC && size < dtcm_usable) {
+			void * p = dtcm_pool + dtcm_used;
+			dtcm_used += size;
+			dtcm_usable -= size;
+			if (clear) ::memset(p, 0, size);
+			return p;
+		}
+		#endif
 		if (size < sram_usable) {
 			void * p = sram_pool + sram_used;
 			sram_used += size;
 			sram_usable -= size;
+			if (clear) ::memset(p, 0, size);
 			return p;
 		} else if (size < sdram_usable) {
-			void * p = sdram_pool + sdram_used;
+			// the allocation spans distances from sdram_used to end from this app's end,
+			// or from far to OOPSY_SDRAM_SIZE - sdram_used from the other end:
+			const int e = sdram_end, o = !sdram_end;
+			const uint32_t end = sdram_used + size, far = OOPSY_SDRAM_SIZE - end;
+			if (clear) {
+				sdram_zero(e, sdram_used, end < sdram_dirty[e] ? end : sdram_dirty[e]);
+				sdram_zero(o, far, sdram_dirty[o] < OOPSY_SDRAM_SIZE - sdram_used ? sdram_dirty[o] : OOPSY_SDRAM_SIZE - sdram_used);
+			}
+			// the app will write to it, so it is dirty from now on, and counted from this end:
+			if (sdram_dirty[e] < end) sdram_dirty[e] = end;
+			if (sdram_dirty[o] > far) sdram_dirty[o] = far;
+			void * p = sdram_pool + (e ? far : sdram_used);
 			sdram_used += size;
 			sdram_usable -= size;
 			return p;
 		}
 		return nullptr;
-	}	
+	}
 
-	void memset(void *p, int c, long size) {
-		char *p2 = (char *)p;
-		int i;
-		for (i = 0; i < size; i++, p2++) *p2 = char(c);
+	// called from the main loop, to clear (a little at a time) any dirty SDRAM that the current app isn't using:
+	void clear_idle() {
+		const int e = sdram_end, o = !sdram_end;
+		if (sdram_dirty[o]) {
+			const uint32_t n = sdram_dirty[o] < OOPSY_CLEAR_IDLE_BYTES ? sdram_dirty[o] : OOPSY_CLEAR_IDLE_BYTES;
+			sdram_zero(o, sdram_dirty[o] - n, sdram_dirty[o]);
+			sdram_dirty[o] -= n;
+		} else if (sdram_dirty[e] > sdram_used) {
+			const uint32_t n = sdram_dirty[e] - sdram_used < OOPSY_CLEAR_IDLE_BYTES ? sdram_dirty[e] - sdram_used : OOPSY_CLEAR_IDLE_BYTES;
+			sdram_zero(e, sdram_dirty[e] - n, sdram_dirty[e]);
+			sdram_dirty[e] -= n;
+		}
 	}
 
 	// void genlib_memcpy(void *dst, const void *src, long size) {
@@ -130,9 +229,143 @@ namespace oopsy {
 		const char * name;
 		void (*load)();
 	};
+
+	#ifdef OOPSY_TARGET_HAS_OLED
+	// MODE_SPECTRUM: the audio callback only copies one channel into a ring, 
+	// and the main loop runs a real FFT of the latest OOPSY_SPECTRUM_SIZE samples over it, 
+	// one stage per call of step(), into log-frequency columns (in dB) for the display.
+	#ifndef OOPSY_SPECTRUM_SIZE
+	#define OOPSY_SPECTRUM_SIZE (512) // a power of 2
+	#endif
+	#ifndef OOPSY_SPECTRUM_FLOOR
+	#define OOPSY_SPECTRUM_FLOOR (-96.f) // dB at the bottom of the display
+	#endif
+	#ifndef OOPSY_SPECTRUM_FALL
+	#define OOPSY_SPECTRUM_FALL (3.f) // dB per frame
+	#endif
+	#ifndef OOPSY_SPECTRUM_PEAK_FALL
+	#define OOPSY_SPECTRUM_PEAK_FALL (0.25f) // dB per frame
+	#endif
+	struct Spectrum {
+		enum {
+			N = OOPSY_SPECTRUM_SIZE,
+			M = N/2, // the real FFT is an M-point complex FFT of (even, odd) sample pairs
+			RING = 2*N,
+			COLUMNS = OOPSY_OLED_DISPLAY_WIDTH
+		};
+		static_assert((N & (N-1)) == 0 && N >= 8, "OOPSY_SPECTRUM_SIZE must be a power of 2, of at least 8");
+		// the audio callback writes a block ahead into the half of the ring that step() isn't reading:
+		static_assert(OOPSY_BLOCK_SIZE <= N, "OOPSY_SPECTRUM_SIZE must be at least the block size");
+		// written by the audio callback:
+		float ring[RING];
+		volatile uint32_t written;
+		// the rest belongs to the main loop:
+		float window[N];
+		float twiddle[M][2]; // cos & sin of 2pi k/N
+		float re[M], im[M], power[M];
+		uint16_t column_bins[COLUMNS+1];
+		float level[COLUMNS], peak[COLUMNS]; // dB
+		int stage, span;
+		int ready; // columns are waiting to be drawn
+
+		void init() {
+			for (int i=0; i<N; i++) window[i] = 0.5f - 0.5f*cosf(float(GENLIB_PI*2.)*i/N); // Hann
+			for (int k=0; k<M; k++) {
+				twiddle[k][0] = cosf(float(GENLIB_PI*2.)*k/N);
+				twiddle[k][1] = sinf(float(GENLIB_PI*2.)*k/N);
+			}
+			// columns are spaced logarithmically from the first bin to the last,
+			// except at the bottom, where that would put them less than a bin apart, and they are a bin apart instead
+			// (or evenly spread, if there are fewer bins than columns):
+			const float last = float(M-1), least = (M-2 < COLUMNS) ? float(M-2)/COLUMNS : 1.f;
+			float bin = 1.f;
+			for (int c=0; c<COLUMNS; c++) {
+				column_bins[c] = uint16_t(bin);
+				float next = bin * powf(last/bin, 1.f/(COLUMNS-c));
+				bin = (next - bin < least) ? bin + least : next;
+			}
+			column_bins[COLUMNS] = M-1;
+			reset();
+			written = 0;
+		}
+
+		void reset() {
+			for (int c=0; c<COLUMNS; c++) level[c] = peak[c] = OOPSY_SPECTRUM_FLOOR;
+			stage = 0;
+			ready = 0;
+		}
+
+		// from the audio callback:
+		inline void write(const float * in, size_t size) {
+			uint32_t w = written;
+			for (size_t i=0; i<size; i++) ring[(w + i) & (RING-1)] = in[i];
+			written = w + size;
+		}
+
+		// from the main loop, returns true when new columns are ready
+		bool step() {
+			if (stage == 0) {
+				// wait until the last frame has been drawn, and a whole frame has been written:
+				uint32_t w = written;
+				if (ready || w < N) return false;
+				// the audio callback writes ahead of w, into the half of the ring not read here: 
+				uint32_t start = w - N;
+				for (int k=0; k<M; k++) {
+					int j = 0;
+					for (int b=1, r=M/2; b<M; b <<= 1, r >>= 1) if (k & b) j |= r; // bit reversed
+					re[j] = ring[(start + 2*k) & (RING-1)] * window[2*k];
+					im[j] = ring[(start + 2*k+1) & (RING-1)] * window[2*k+1];
+				}
+				span = 1;
+				stage = 1;
+			} else if (span < M) {
+				// one radix-2 pass, combining pairs of FFTs of size span:
+				int stride = M/span; // twiddle index step, for angles of 2pi k/(2*span)
+				for (int g=0; g<M; g += 2*span) {
+					for (int k=0; k<span; k++) {
+						float wr = twiddle[k*stride][0], wi = -twiddle[k*stride][1];
+						int a = g + k, b = a + span;
+						float tr = re[b]*wr - im[b]*wi;
+						float ti = re[b]*wi + im[b]*wr;
+						re[b] = re[a] - tr; im[b] = im[a] - ti;
+						re[a] += tr; im[a] += ti;
+					}
+				}
+				span *= 2;
+			} else {
+				// split into the spectrum of the real input:
+				float scale = 16.f/(float(N)*float(N)); // so that a full-scale sine is 0dB
+				for (int k=1; k<M; k++) {
+					int m = M - k;
+					float er = 0.5f*(re[k] + re[m]), ei = 0.5f*(im[k] - im[m]);
+					float odr = 0.5f*(im[k] + im[m]), odi = -0.5f*(re[k] - re[m]);
+					float wr = twiddle[k][0], wi = -twiddle[k][1];
+					float xr = er + odr*wr - odi*wi;
+					float xi = ei + odr*wi + odi*wr;
+					power[k] = (xr*xr + xi*xi)*scale;
+				}
+				// the loudest bin of each column, with falling levels and peaks:
+				for (int c=0; c<COLUMNS; c++) {
+					int lo = column_bins[c], hi = column_bins[c+1] > lo ? column_bins[c+1] : lo+1;
+					float loudest = 0.f;
+					for (int k=lo; k<hi; k++) loudest = power[k] > loudest ? power[k] : loudest;
+					float db = loudest > 1e-12f ? 10.f*log10f(loudest) : OOPSY_SPECTRUM_FLOOR;
+					db = db < OOPSY_SPECTRUM_FLOOR ? OOPSY_SPECTRUM_FLOOR : db;
+					level[c] = db > level[c] - OOPSY_SPECTRUM_FALL ? db : level[c] - OOPSY_SPECTRUM_FALL;
+					peak[c] = db > peak[c] - OOPSY_SPECTRUM_PEAK_FALL ? db : peak[c] - OOPSY_SPECTRUM_PEAK_FALL;
+				}
+				stage = 0;
+				ready = 1;
+				return true;
+			}
+			return false;
+		}
+	};
+	#endif // OOPSY_TARGET_HAS_OLED
 	typedef enum {
 		#ifdef OOPSY_TARGET_HAS_OLED
 			MODE_SCOPE,
+			MODE_SPECTRUM,
 			#ifdef OOPSY_HAS_PARAM_VIEW
 				MODE_PARAMS,
 			#endif
@@ -144,7 +377,126 @@ namespace oopsy {
 		MODE_COUNT
 	} Mode;
 
-	
+	#ifdef OOPSY_USE_PRESETS
+	#ifndef OOPSY_PRESET_SLOTS
+	#define OOPSY_PRESET_SLOTS (8)
+	#endif
+	// presets are stored in the last 128KB of the QSPI flash, as two banks of 64KB
+	#ifndef OOPSY_PRESET_FLASH_OFFSET
+	#define OOPSY_PRESET_FLASH_OFFSET (0x7E0000)
+	#endif
+	#define OOPSY_PRESET_BANK_SIZE (0x10000)
+	#define OOPSY_PRESET_MAGIC (0x7073796f) // "oysp"
+
+	struct PresetRecord {
+		uint32_t magic;
+		uint32_t seq;		// increments with every record written
+		uint16_t app, slot;
+		uint32_t check;		// sum of the payload words, to detect incomplete writes
+	};
+	// records have a fixed stride, so the log can be scanned without parsing payloads:
+	static const uint32_t OOPSY_PRESET_STRIDE = sizeof(PresetRecord) + OOPSY_PRESET_SIZE;
+	static const uint32_t OOPSY_PRESET_RECORDS = OOPSY_PRESET_BANK_SIZE / OOPSY_PRESET_STRIDE;
+
+	// Saving a preset appends a record to the log in the active bank, rather than erasing & rewriting a slot.
+	// When the active bank is full, the latest record of each app & slot is copied to the other (erased) bank, 
+	// which then becomes active. This way each flash sector is only erased once per bank-full of saves. 
+	struct PresetStore {
+		daisy::QSPIHandle * qspi = nullptr;
+		uint32_t seq = 0, bank = 0, head = 0; // head: index of the next free record in the active bank
+		uint32_t buffer[OOPSY_PRESET_STRIDE/4]; // the flash is not memory-mapped while writing, so records are staged here
+
+		uint32_t address(uint32_t b, uint32_t idx) {
+			return OOPSY_PRESET_FLASH_OFFSET + b*OOPSY_PRESET_BANK_SIZE + idx*OOPSY_PRESET_STRIDE;
+		}
+
+		const PresetRecord * record(uint32_t b, uint32_t idx) {
+			return (const PresetRecord *)qspi->GetData(address(b, idx));
+		}
+
+		static uint32_t checksum(const uint32_t * words) {
+			uint32_t sum = 0;
+			for (uint32_t i=0; i<OOPSY_PRESET_SIZE/4; i++) sum += words[i];
+			return sum;
+		}
+
+		static bool valid(const PresetRecord * r) {
+			return r->magic == OOPSY_PRESET_MAGIC && r->check == checksum((const uint32_t *)(r+1));
+		}
+
+		// find the end of the log, and copy the latest snapshot of each slot of this app into cache:
+		void load(uint16_t app, uint32_t (*cache)[OOPSY_PRESET_SIZE/4], uint8_t * cached) {
+			uint32_t latest[OOPSY_PRESET_SLOTS] = { 0 };
+			uint32_t used[2] = { 0, 0 };
+			seq = 0;
+			bank = 0;
+			for (uint32_t b=0; b<2; b++) {
+				for (uint32_t i=0; i<OOPSY_PRESET_RECORDS; i++) {
+					const PresetRecord * r = record(b, i);
+					if (r->magic == 0xFFFFFFFF) break; // erased flash: end of this bank's log
+					used[b] = i+1;
+					if (!valid(r)) continue;
+					if (r->seq > seq) {
+						seq = r->seq;
+						bank = b;
+					}
+					if (r->app == app && r->slot < OOPSY_PRESET_SLOTS && r->seq > latest[r->slot]) {
+						latest[r->slot] = r->seq;
+						memcpy(cache[r->slot], r+1, OOPSY_PRESET_SIZE);
+						cached[r->slot] = 1;
+					}
+				}
+			}
+			head = used[bank];
+		}
+
+		void write(uint32_t b, uint32_t idx, uint16_t app, uint16_t slot, const void * payload) {
+			PresetRecord * r = (PresetRecord *)buffer;
+			memcpy(r+1, payload, OOPSY_PRESET_SIZE);
+			r->magic = OOPSY_PRESET_MAGIC;
+			r->seq = ++seq;
+			r->app = app;
+			r->slot = slot;
+			r->check = checksum((const uint32_t *)(r+1));
+			qspi->Write(address(b, idx), OOPSY_PRESET_STRIDE, (uint8_t *)buffer);
+		}
+
+		// copy the latest record of each app & slot into the other bank, and make it active
+		// (skipping the app & slot about to be saved, since its new record supersedes them all):
+		void compact(uint16_t skip_app, uint16_t skip_slot) {
+			uint32_t other = !bank, n = 0;
+			qspi->Erase(address(other, 0), address(other, 0) + OOPSY_PRESET_BANK_SIZE);
+			for (uint32_t i=0; i<head && n<OOPSY_PRESET_RECORDS; i++) {
+				const PresetRecord * r = record(bank, i);
+				if (!valid(r)) continue;
+				if (r->app == skip_app && r->slot == skip_slot) continue;
+				bool superseded = false;
+				for (uint32_t j=i+1; j<head && !superseded; j++) {
+					const PresetRecord * later = record(bank, j);
+					superseded = valid(later) && later->app == r->app && later->slot == r->slot;
+				}
+				if (superseded) continue;
+				// write() stages through buffer, so copy out of the memory-mapped flash first:
+				uint32_t payload[OOPSY_PRESET_SIZE/4];
+				uint16_t app = r->app, slot = r->slot;
+				memcpy(payload, r+1, OOPSY_PRESET_SIZE);
+				write(other, n++, app, slot, payload);
+			}
+			bank = other;
+			head = n;
+		}
+
+		// returns false if the bank cannot hold this record even after compaction:
+		bool save(uint16_t app, uint16_t slot, const void * payload) {
+			if (head >= OOPSY_PRESET_RECORDS) compact(app, slot);
+			// the generator rejects preset sizes that don't fit, but never write past the bank:
+			if (head >= OOPSY_PRESET_RECORDS) return false;
+			write(bank, head++, app, slot, payload);
+			return true;
+		}
+	};
+	#endif // OOPSY_USE_PRESETS
+
 
 	struct GenDaisy {
 
@@ -179,6 +531,24 @@ namespace oopsy {
 		void * app = nullptr;
 		void * gen = nullptr;
 		bool nullAudioCallbackRunning = false;
+
+		#ifdef OOPSY_USE_PRESETS
+		size_t (*getstateCallback)(char * state);
+		size_t (*setstateCallback)(const char * state);
+		size_t (*morphstateCallback)(const char * a, const char * b, float mix);
+		PresetStore presets;
+		// RAM copies of the current app's presets, so that recall & morph never need to read the flash:
+		uint32_t preset_cache[OOPSY_PRESET_SLOTS][OOPSY_PRESET_SIZE/4];
+		uint8_t preset_cached[OOPSY_PRESET_SLOTS];
+		// slots saved by the audio thread, waiting to be written to flash by the main loop:
+		volatile uint8_t preset_unsaved[OOPSY_PRESET_SLOTS];
+		// a snapshot of a slot taken with the audio interrupt masked, so the flash write never sees a half-updated slot:
+		uint32_t preset_staged[OOPSY_PRESET_SIZE/4];
+		// requests from the app, applied at the next block boundary:
+		volatile int preset_recall_slot = -1, preset_save_slot = -1;
+		int preset_app = 0, preset_morph_a = 0, preset_morph_b = 0, preset_morph_pending = 0;
+		float preset_morph_mix = 0.f;
+		#endif
 		
 		#ifdef OOPSY_TARGET_HAS_OLED
 
@@ -207,6 +577,8 @@ namespace oopsy {
 		char ** console_lines;
 		float scope_data[OOPSY_OLED_DISPLAY_WIDTH*2][2]; // 128 pixels
 		char scope_label[11];
+		Spectrum spectrum;
+		uint_fast8_t spectrum_source = OOPSY_IO_COUNT; // out1
 		#endif // OOPSY_TARGET_HAS_OLED
 
 		#ifdef OOPSY_TARGET_USES_MIDI_UART
@@ -261,7 +633,7 @@ namespace oopsy {
 		uint8_t midi_in_written = 0;//, midi_out_written = 0;
 		uint8_t midi_in_active = 0, midi_out_active = 0;
 		uint8_t midi_out_data[OOPSY_MIDI_BUFFER_SIZE];
-		float midi_in_data[OOPSY_BLOCK_SIZE];
+		float * midi_in_data = scratch[0];
 		int midi_data_idx = 0;
 		int midi_parse_state = 0;
 		#endif //OOPSY_TARGET_USES_MIDI_UART
@@ -352,7 +724,7 @@ namespace oopsy {
 						for (size_t f=0; f<frames_read; f++) {
 							for (size_t c=0; c<buffer_channels; c++) {
 								uint8_t * frame = workspace + f*format.bytesperframe + (c % format.chans)*bytespersample;
-								buffer[(buffer_index+f)*buffer_channels + c] = ((int16_t *)frame)[0] * 0.000030517578125f;
+								buffer[gendata.offset(buffer_index+f, c)] = ((int16_t *)frame)[0] * 0.000030517578125f;
 							}
 						}
 					} break;
@@ -365,7 +737,7 @@ namespace oopsy {
 									((uint32_t)(frame[1]) << 16) | 
 									((uint32_t)(frame[2]) << 24)
 								) >> 8;
-								buffer[(buffer_index+f)*buffer_channels + c] = (float)(((double)b) * 0.00000011920928955078125);
+								buffer[gendata.offset(buffer_index+f, c)] = (float)(((double)b) * 0.00000011920928955078125);
 							}
 						}
 					} break;
@@ -373,7 +745,7 @@ namespace oopsy {
 						for (size_t f=0; f<frames_read; f++) {
 							for (size_t c=0; c<buffer_channels; c++) {
 								uint8_t * frame = workspace + f*format.bytesperframe + (c % format.chans)*bytespersample;
-								buffer[(buffer_index+f)*buffer_channels + c] = ((int32_t *)frame)[0] / 2147483648.f;
+								buffer[gendata.offset(buffer_index+f, c)] = ((int32_t *)frame)[0] / 2147483648.f;
 							}
 						}
 					} break;
@@ -383,6 +755,7 @@ namespace oopsy {
 			} while (!f_eof(&SDFile) && bytesread > 0 && total_frames_to_read > 0);
 			f_close(&SDFile);
 			log("read %s", filename);
+			OOPSY_PROFILE_MARK(filename);
 			return buffer_index;
 		badwav:
 			f_close(&SDFile);
@@ -391,6 +764,68 @@ namespace oopsy {
 		}
 		#endif
 
+		#ifdef OOPSY_USE_PRESETS
+		// request a recall of a preset (slot counting from 0), applied at the next block boundary:
+		void preset_recall(int slot) {
+			if (slot >= 0 && slot < OOPSY_PRESET_SLOTS) preset_recall_slot = slot;
+		}
+
+		// request a snapshot of the current state into a preset slot, taken at the next block boundary:
+		void preset_save(int slot) {
+			if (slot >= 0 && slot < OOPSY_PRESET_SLOTS) preset_save_slot = slot;
+		}
+
+		// morph between adjacent presets, e.g. 1.25 is a quarter of the way from slot 1 to slot 2:
+		void preset_morph(float position) {
+			if (position < 0.f) position = 0.f;
+			if (position > OOPSY_PRESET_SLOTS-1) position = OOPSY_PRESET_SLOTS-1;
+			preset_morph_a = int(position);
+			preset_morph_b = (preset_morph_a < OOPSY_PRESET_SLOTS-1) ? preset_morph_a+1 : preset_morph_a;
+			preset_morph_mix = position - preset_morph_a;
+			preset_morph_pending = 1;
+		}
+
+		// called at the start of each audio block; all of these only touch RAM, so they are fast
+		void preset_preperform() {
+			if (preset_save_slot >= 0) {
+				int slot = preset_save_slot;
+				preset_save_slot = -1;
+				getstateCallback((char *)preset_cache[slot]);
+				preset_cached[slot] = 1;
+				preset_unsaved[slot] = 1;
+			}
+			if (preset_recall_slot >= 0) {
+				int slot = preset_recall_slot;
+				preset_recall_slot = -1;
+				if (preset_cached[slot]) setstateCallback((const char *)preset_cache[slot]);
+			}
+			if (preset_morph_pending) {
+				preset_morph_pending = 0;
+				if (preset_cached[preset_morph_a] && preset_cached[preset_morph_b]) {
+					morphstateCallback((const char *)preset_cache[preset_morph_a], (const char *)preset_cache[preset_morph_b], preset_morph_mix);
+				}
+			}
+		}
+
+		// called from the main loop, to write any newly saved presets to flash:
+		void preset_service() {
+			for (int i=0; i<OOPSY_PRESET_SLOTS; i++) {
+				if (!preset_unsaved[i]) continue;
+				// the audio interrupt may overwrite this slot at any time, so copy it out atomically:
+				uint32_t primask = __get_PRIMASK();
+				__disable_irq();
+				memcpy(preset_staged, preset_cache[i], OOPSY_PRESET_SIZE);
+				preset_unsaved[i] = 0;
+				__set_PRIMASK(primask);
+				if (presets.save(preset_app, i, preset_staged)) {
+					log("saved preset %d", i+1);
+				} else {
+					log("preset %d not saved: flash full", i+1);
+				}
+			}
+		}
+		#endif // OOPSY_USE_PRESETS
+
 		template<typename A>
 		void reset(A& newapp) {
 			// first, remove callbacks:
@@ -399,22 +834,52 @@ namespace oopsy {
 			nullAudioCallbackRunning = false;
 			sub_board->ChangeAudioCallback(nullAudioCallback);
 			while (!nullAudioCallbackRunning) daisy::System::Delay(1);
+			OOPSY_PROFILE_MARK("stop audio");
+			#ifdef OOPSY_USE_PRESETS
+			// make sure the outgoing app's presets are stored:
+			preset_service();
+			OOPSY_PROFILE_MARK("save presets");
+			#endif
 			// reset memory
 			oopsy::init();
+			// (the shared sine table is built once, on first use)
+			genlib_sinetable();
+			OOPSY_PROFILE_MARK("sine table");
 			// install new app:
 			app = &newapp;
 			newapp.init(*this);
+			OOPSY_PROFILE_MARK("app init");
 			// install new callbacks:
 			mainloopCallback = newapp.staticMainloopCallback;
 			displayCallback = newapp.staticDisplayCallback;
 			#if defined(OOPSY_TARGET_HAS_OLED) && defined(OOPSY_HAS_PARAM_VIEW)
 			paramCallback = newapp.staticParamCallback;
 			#endif
+			#ifdef OOPSY_USE_PRESETS
+			getstateCallback = newapp.staticGetStateCallback;
+			setstateCallback = newapp.staticSetStateCallback;
+			morphstateCallback = newapp.staticMorphStateCallback;
+			preset_app = app_selected;
+			preset_recall_slot = preset_save_slot = -1;
+			preset_morph_pending = 0;
+			for (int i=0; i<OOPSY_PRESET_SLOTS; i++) {
+				preset_cached[i] = 0;
+				preset_unsaved[i] = 0;
+			}
+			presets.load(preset_app, preset_cache, preset_cached);
+			OOPSY_PROFILE_MARK("load presets");
+			#endif
 
+			#ifdef OOPSY_PROFILE
+			profile.waiting = 1;
+			#endif
 			sub_board->ChangeAudioCallback(newapp.staticAudioCallback);
 			log("gen~ %s", appdefs[app_selected].name);
 			log("SR %dkHz / %dHz", (int)(sub_board->AudioSampleRate()/1000), (int)sub_board->AudioCallbackRate());
 			{
+				#ifdef OOPSY_TCM
+				log("DTCM %dKB/%dKB", (int)(oopsy::dtcm_used+1023)/1024, OOPSY_DTCM_SIZE/1024);
+				#endif
 				log("%d%s/%dKB+%d%s/%dMB", 
 					oopsy::sram_used > 1024 ? oopsy::sram_used/1024 : oopsy::sram_used, 
 					(oopsy::sram_used > 1024 || oopsy::sram_used == 0) ? "" : "B", 
@@ -470,6 +935,7 @@ namespace oopsy {
 
 			// TODO REMOVE THIS HACK WHEN STARTING SERIAL OVER USB DOESN'T FREAK OUT WITH AUDIO CALLBACK
 			daisy::System::Delay(275);
+			OOPSY_PROFILE_MARK("usb log");
 			#endif
 			
 			#ifdef OOPSY_TARGET_HAS_OLED
@@ -481,15 +947,20 @@ namespace oopsy {
 				console_lines[i] = &console_memory[i*console_cols];
 			}
 			console_line = console_rows-1;
+			spectrum.init();
 			#endif
 
+			#ifndef OOPSY_NO_ADC
 			sub_board->adc.Start();
+			#endif
 			sub_board->StartAudio(nullAudioCallback);
 			mainloopCallback = nullMainloopCallback;
 			displayCallback = nullMainloopCallback;
+			OOPSY_PROFILE_MARK("start audio");
 
 			#ifdef OOPSY_TARGET_USES_SDMMC
 			sdcard_init();
+			OOPSY_PROFILE_MARK("sdcard init");
 			#endif
 
 			#ifdef OOPSY_TARGET_USES_MIDI_UART
@@ -509,6 +980,11 @@ namespace oopsy {
 			config.pin_config.tx = {DSY_GPIOB, 6};
 			uart.Init(config);
 			uart.StartRx();
+			OOPSY_PROFILE_MARK("midi init");
+			#endif
+
+			#ifdef OOPSY_USE_PRESETS
+			presets.qspi = &sub_board->qspi;
 			#endif
 
 			app_selected = 0;
@@ -528,12 +1004,24 @@ namespace oopsy {
 
 				if (app_load_scheduled) {
 					app_load_scheduled = 0;
+					OOPSY_PROFILE_BEGIN();
 					appdefs[app_selected].load();
 					continue;
 				}
 				
 				// handle app-level code (e.g. for CV/gate outs)
 				mainloopCallback(t, dt);
+				oopsy::clear_idle();
+				#ifdef OOPSY_PROFILE
+				if (!profile.waiting && !profile.reported) profile_report();
+				#endif
+				#ifdef OOPSY_USE_PRESETS
+				preset_service();
+				#endif
+				#ifdef OOPSY_TARGET_HAS_OLED
+				// one stage of the spectrum analysis per loop:
+				if (mode == MODE_SPECTRUM) spectrum.step();
+				#endif
 				#ifdef OOPSY_TARGET_USES_MIDI_UART
 				// send data if there's something to read:
 				if (midi_out_readidx != midi_out_writeidx) {
@@ -642,6 +1130,9 @@ namespace oopsy {
 								scope_zoom = (scope_zoom + menu_button_incr) % OOPSY_SCOPE_MAX_ZOOM;
 							} break;
 						}
+					} else if (mode == MODE_SPECTRUM) {
+						int sources = OOPSY_IO_COUNT*2;
+						spectrum_source = (spectrum_source + sources + menu_button_incr % sources) % sources;
 					#ifdef OOPSY_HAS_PARAM_VIEW
 					} else if (mode == MODE_PARAMS) {
 						if (!param_is_tweaking) {
@@ -672,6 +1163,8 @@ namespace oopsy {
 						#ifdef OOPSY_TARGET_HAS_OLED
 						} else if (mode == MODE_SCOPE) {
 							scope_option = (scope_option + 1) % SCOPEOPTION_COUNT;
+						} else if (mode == MODE_SPECTRUM) {
+							spectrum.reset(); // clear the peaks
 						#if defined (OOPSY_HAS_PARAM_VIEW) && defined(OOPSY_CAN_PARAM_TWEAK)
 						} else if (mode == MODE_PARAMS) {
 							param_is_tweaking = !param_is_tweaking;
@@ -805,6 +1298,23 @@ namespace oopsy {
 								// for view style, just leave it blank :-)
 							}
 						} break;
+						case MODE_SPECTRUM: {
+							showstats = 1;
+							uint8_t h = OOPSY_OLED_DISPLAY_HEIGHT;
+							float scale = (h-1)/-OOPSY_SPECTRUM_FLOOR;
+							// bars for the levels, a pixel for the peaks, from 0dB at the top:
+							for (uint_fast8_t i=0; i<OOPSY_OLED_DISPLAY_WIDTH; i++) {
+								int y = (h-1) - int((spectrum.level[i] - OOPSY_SPECTRUM_FLOOR)*scale);
+								if (y < h-1) hardware.display.DrawLine(i, h-1, i, y < 0 ? 0 : y, 1);
+								y = (h-1) - int((spectrum.peak[i] - OOPSY_SPECTRUM_FLOOR)*scale);
+								hardware.display.DrawPixel(i, y < 0 ? 0 : y, 1);
+							}
+							spectrum.ready = 0;
+							int n = spectrum_source % OOPSY_IO_COUNT;
+							snprintf(scope_label, sizeof(scope_label), "%s%d", spectrum_source < OOPSY_IO_COUNT ? "in" : "out", n+1);
+							hardware.display.SetCursor(0, 0);
+							hardware.display.WriteString(scope_label, font, true);
+						} break;
 						case MODE_CONSOLE: 
 						{
 							showstats = 1;
@@ -852,7 +1362,7 @@ namespace oopsy {
 			app_load_scheduled = 1;
 		}
 
-		void audio_preperform(size_t size) {
+		OOPSY_ITCM void audio_preperform(size_t size) {
 			#ifdef OOPSY_TARGET_USES_MIDI_UART
 			// fill remainder of midi buffer with non-data:
 			for (size_t i=midi_in_written; i<size; i++) midi_in_data[i] = -0.1f;
@@ -862,6 +1372,10 @@ namespace oopsy {
 
 			hardware.ProcessAllControls();
 
+			#ifdef OOPSY_USE_PRESETS
+			preset_preperform();
+			#endif
+
 			#if defined(OOPSY_TARGET_SEED)
 			menu_button_incr += hardware.menu_rotate;
 			menu_button_held_ms = hardware.menu_hold;
@@ -884,7 +1398,7 @@ namespace oopsy {
 			#endif
 		}
 
-		void audio_postperform(float **buffers, size_t size) {
+		OOPSY_ITCM void audio_postperform(float **buffers, size_t size) {
 			#ifdef OOPSY_TARGET_HAS_OLED
 			if (mode == MODE_SCOPE) {
 				// selector for scope storage source:
@@ -919,6 +1433,9 @@ namespace oopsy {
 					scope_step++;
 					if (scope_step >= OOPSY_OLED_DISPLAY_WIDTH*2) scope_step = 0;
 				}
+			} else if (mode == MODE_SPECTRUM) {
+				// all the analysis happens in the main loop:
+				spectrum.write(buffers[spectrum_source], size);
 			}
 			#endif
 			blockcount++;
@@ -945,6 +1462,19 @@ namespace oopsy {
 		}
 		#endif // OOPSY_TARGET_HAS_OLED
 
+		#ifdef OOPSY_PROFILE
+		void profile_report() {
+			char line[32];
+			for (int i=0; profile.line(i, line, sizeof(line)); i++) {
+				log("%s", line);
+				#ifdef OOPSY_USE_LOGGING
+				sub_board->PrintLine("%s", line);
+				#endif
+			}
+			profile.reported = 1;
+		}
+		#endif
+
 		GenDaisy& log(const char * fmt, ...) {
 			#ifdef OOPSY_TARGET_HAS_OLED
 			va_list argptr;
@@ -1073,8 +1603,18 @@ namespace oopsy {
 			self.displayCallback(daisy, t, dt);
 		}
 
-		static void staticAudioCallback(daisy::AudioHandle::InputBuffer hardware_ins, daisy::AudioHandle::OutputBuffer hardware_outs, size_t size) {
+		OOPSY_ITCM static void staticAudioCallback(daisy::AudioHandle::InputBuffer hardware_ins, daisy::AudioHandle::OutputBuffer hardware_outs, size_t size) {
 			uint32_t start = daisy::System::GetUs(); 
+			#ifdef OOPSY_PROFILE
+			if (profile.waiting) {
+				profile.mark("first audio");
+				profile.waiting = 0;
+			}
+			#endif
+			#ifdef GENLIB_FLUSH_DENORMALS
+			// FPSCR is reset on each interrupt entry, so this must be done every time:
+			genlib_flush_denormals();
+			#endif
 			daisy.audio_preperform(size);
 			((T *)daisy.app)->audioCallback(daisy, hardware_ins, hardware_outs, size);
 			#if (OOPSY_IO_COUNT == 4)
@@ -1100,6 +1640,23 @@ namespace oopsy {
 			self.paramCallback(daisy, idx, label, len, tweak);
 		}
 		#endif //defined(OOPSY_TARGET_HAS_OLED) && defined(OOPSY_HAS_PARAM_VIEW)
+
+		#ifdef OOPSY_USE_PRESETS
+		static size_t staticGetStateCallback(char * state) {
+			T& self = *(T *)daisy.app;
+			return self.getstate(daisy, state);
+		}
+
+		static size_t staticSetStateCallback(const char * state) {
+			T& self = *(T *)daisy.app;
+			return self.setstate(daisy, state);
+		}
+
+		static size_t staticMorphStateCallback(const char * a, const char * b, float mix) {
+			T& self = *(T *)daisy.app;
+			return self.morphstate(daisy, a, b, mix);
+		}
+		#endif // OOPSY_USE_PRESETS
 	};
 
 }; // oopsy::
@@ -1116,8 +1673,9 @@ t_ptr genlib_sysmem_newptr(t_ptr_size size) {
 }
 
 t_ptr genlib_sysmem_newptrclear(t_ptr_size size) {
-	t_ptr p = genlib_sysmem_newptr(size);
-	if (p) oopsy::memset(p, 0, size);
+	OOPSY_PROFILE_START(start);
+	t_ptr p = (t_ptr)oopsy::allocate(size, true);
+	OOPSY_PROFILE_ADD("zero memory", start);
 	return p;
 }
 
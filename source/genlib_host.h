@@ -0,0 +1,672 @@
+#ifndef GENLIB_HOST_H
+#define GENLIB_HOST_H
+
+/*
+Oopsy was authored in 2020-2021 by Graham Wakefield.  Copyright 2021 Electrosmith, Corp. and Graham Wakefield.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+	Stands in for genlib_daisy.h when building for the "host" target (`oopsy.js render`)
+
+	The generated App code is the same as for the Daisy,
+	but it is run offline on the desktop, block after block as fast as possible:
+	- audio inputs are read from a WAV file
+	- knobs, gates and MIDI input are driven by a control script
+	- audio outputs are written to WAV files, and MIDI output is counted
+	- every app x samplerate x blocksize combination is a render job, run on a pool of threads
+*/
+
+#include "genlib.h"
+#include "genlib_ops.h"
+#include "genlib_exportfunctions.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <cstring> // memset
+#include <stdarg.h> // vprintf
+
+#ifdef OOPSY_USE_PRESETS
+#ifndef OOPSY_PRESET_SLOTS
+#define OOPSY_PRESET_SLOTS (8)
+#endif
+#endif
+
+// code & memory placement (see OOPSY_TCM in genlib_daisy.h) means nothing here:
+#define OOPSY_ITCM
+#define OOPSY_ITCM_FLATTEN
+#define OOPSY_DTCM
+
+#ifndef OOPSY_HOST_KNOBS
+#define OOPSY_HOST_KNOBS (4)
+#endif
+#ifndef OOPSY_HOST_GATES
+#define OOPSY_HOST_GATES (2)
+#endif
+
+// stand-ins for the few parts of libDaisy that generated code refers to:
+namespace daisy {
+	struct AudioHandle {
+		typedef const float * const * InputBuffer;
+		typedef float ** OutputBuffer;
+	};
+
+	struct System {
+		static void ResetToBootloader() {}
+	};
+};
+
+// the host "hardware"; inputs are set by the control script, outputs are only stored
+struct Daisy {
+	struct {
+		float samplerate;
+		size_t blocksize;
+
+		float AudioSampleRate() { return samplerate; }
+		size_t AudioBlockSize() { return blocksize; }
+	} seed;
+
+	float knob[OOPSY_HOST_KNOBS];
+	float gate_in[OOPSY_HOST_GATES];
+	float cv_out[2];
+	float gate_out[2];
+};
+
+// with one scratch arena, and one profile, per render thread:
+#define OOPSY_SCRATCH_STORAGE thread_local
+#define OOPSY_PROFILE_STORAGE thread_local
+#define OOPSY_PROFILE_NOW() (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
+#include "genlib_oopsy.h"
+
+namespace oopsy {
+
+	// seeds for [noise], counting from 1 in each render as they do from boot on the Daisy:
+	thread_local unsigned long render_ticks = 0;
+
+	// audio files are held as interleaved floats:
+	struct Wav {
+		uint32_t samplerate = 0;
+		uint32_t chans = 0;
+		size_t frames = 0;
+		std::vector<float> samples;
+
+		// reads 16, 24 or 32 bit PCM, or 32 bit float; returns 0 on success
+		int read(const char * path) {
+			FILE * f = fopen(path, "rb");
+			if (!f) return -1;
+			char id[4];
+			uint32_t size, format = 0, bits = 0;
+			if (fread(id, 1, 4, f) != 4 || memcmp(id, "RIFF", 4)
+				|| fread(&size, 4, 1, f) != 1
+				|| fread(id, 1, 4, f) != 4 || memcmp(id, "WAVE", 4)) { fclose(f); return -1; }
+			while (fread(id, 1, 4, f) == 4 && fread(&size, 4, 1, f) == 1) {
+				if (!memcmp(id, "fmt ", 4)) {
+					uint8_t fmt[16];
+					if (size < 16 || fread(fmt, 1, 16, f) != 16) break;
+					format = fmt[0] | (fmt[1] << 8);
+					chans = fmt[2] | (fmt[3] << 8);
+					samplerate = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | (fmt[7] << 24);
+					bits = fmt[14] | (fmt[15] << 8);
+					// WAVE_FORMAT_EXTENSIBLE keeps the real format in the sub-format GUID:
+					if (format == 0xFFFE && size >= 26) {
+						uint8_t ext[10];
+						if (fread(ext, 1, 10, f) != 10) break;
+						format = ext[8] | (ext[9] << 8);
+						size -= 10;
+					}
+					fseek(f, size - 16 + (size & 1), SEEK_CUR);
+				} else if (!memcmp(id, "data", 4)) {
+					uint32_t bytes = bits/8;
+					if (!chans || !bytes || !(format == 1 || (format == 3 && bits == 32))) break;
+					frames = size / (bytes * chans);
+					samples.resize(frames * chans);
+					std::vector<uint8_t> raw(frames * chans * bytes);
+					if (fread(raw.data(), 1, raw.size(), f) != raw.size()) break;
+					for (size_t i=0; i<samples.size(); i++) {
+						const uint8_t * s = raw.data() + i*bytes;
+						switch (bits) {
+							case 16: samples[i] = int16_t(s[0] | (s[1] << 8)) / 32768.f; break;
+							case 24: samples[i] = (int32_t(s[0] << 8 | s[1] << 16 | s[2] << 24) >> 8) / 8388608.f; break;
+							case 32: {
+								int32_t v = int32_t(s[0] | (s[1] << 8) | (s[2] << 16) | (uint32_t(s[3]) << 24));
+								if (format == 3) memcpy(&samples[i], &v, 4);
+								else samples[i] = v / 2147483648.f;
+							} break;
+							default: samples[i] = (s[0] - 128) / 128.f; break;
+						}
+					}
+					fclose(f);
+					return 0;
+				} else {
+					fseek(f, size + (size & 1), SEEK_CUR);
+				}
+			}
+			fclose(f);
+			return -1;
+		}
+
+		// writes 32 bit float, so that renders can be compared exactly; returns 0 on success
+		int write(const char * path) {
+			FILE * f = fopen(path, "wb");
+			if (!f) return -1;
+			uint32_t bytes = frames * chans * 4;
+			uint32_t riffsize = 4 + 8 + 16 + 8 + bytes;
+			uint32_t fmtsize = 16, byterate = samplerate * chans * 4;
+			uint16_t format = 3, channels = chans, align = chans * 4, bits = 32;
+			fwrite("RIFF", 1, 4, f); fwrite(&riffsize, 4, 1, f); fwrite("WAVE", 1, 4, f);
+			fwrite("fmt ", 1, 4, f); fwrite(&fmtsize, 4, 1, f);
+			fwrite(&format, 2, 1, f); fwrite(&channels, 2, 1, f); fwrite(&samplerate, 4, 1, f);
+			fwrite(&byterate, 4, 1, f); fwrite(&align, 2, 1, f); fwrite(&bits, 2, 1, f);
+			fwrite("data", 1, 4, f); fwrite(&bytes, 4, 1, f);
+			size_t written = fwrite(samples.data(), 4, frames * chans, f);
+			fclose(f);
+			return written == frames * chans ? 0 : -1;
+		}
+	};
+
+	// a line of the control script, e.g. "0.5 kn1 0.25", "1 gt2 1" or "2.25 midi 144 60 100"
+	struct ControlEvent {
+		double time;
+		enum { KNOB, GATE, MIDI } kind;
+		int index;
+		float value;
+		uint8_t bytes[3];
+		int count;
+	};
+
+	// returns 0 on success; anything after a # is ignored
+	int read_control_script(const char * path, std::vector<ControlEvent>& events) {
+		FILE * f = fopen(path, "r");
+		if (!f) return -1;
+		char line[256];
+		int lineno = 0;
+		while (fgets(line, sizeof(line), f)) {
+			lineno++;
+			char * hash = strchr(line, '#');
+			if (hash) *hash = 0;
+			ControlEvent e;
+			char name[32];
+			int n;
+			if (sscanf(line, "%lf %31s %n", &e.time, name, &n) < 2) continue;
+			const char * rest = line + n;
+			if (!strcmp(name, "midi")) {
+				unsigned b[3];
+				e.kind = ControlEvent::MIDI;
+				e.count = sscanf(rest, "%u %u %u", &b[0], &b[1], &b[2]);
+				for (int i=0; i<e.count; i++) e.bytes[i] = b[i];
+			} else if (sscanf(name, "kn%d", &e.index) == 1 && e.index >= 1 && e.index <= OOPSY_HOST_KNOBS) {
+				e.kind = ControlEvent::KNOB;
+				e.count = sscanf(rest, "%f", &e.value);
+			} else if (sscanf(name, "gt%d", &e.index) == 1 && e.index >= 1 && e.index <= OOPSY_HOST_GATES) {
+				e.kind = ControlEvent::GATE;
+				e.count = sscanf(rest, "%f", &e.value);
+			} else {
+				e.count = 0;
+			}
+			if (e.count < 1) {
+				fprintf(stderr, "%s:%d: can't parse control event\n", path, lineno);
+				fclose(f);
+				return -1;
+			}
+			if (e.kind != ControlEvent::MIDI) e.index--; // kn1 is knob[0]
+			events.push_back(e);
+		}
+		fclose(f);
+		std::stable_sort(events.begin(), events.end(), [](const ControlEvent& a, const ControlEvent& b) { return a.time < b.time; });
+		return 0;
+	}
+
+	struct GenDaisy {
+
+		Daisy hardware;
+		void * gen;
+		int param_count = 0;
+		uint32_t blockcount = 0;
+		std::string data_path;
+
+		#ifdef OOPSY_TARGET_USES_MIDI_UART
+
+		struct MidiNote {
+			uint8_t chan, pitch, vel, press;
+
+			void init() {
+				chan = 0;
+				pitch = 36;
+				vel = press = 0;
+			}
+
+			void update(GenDaisy& daisy, uint8_t v, uint8_t p=36, uint8_t c=0) {
+				if (vel && (p != pitch || c != chan)) {
+					vel = 0;
+					daisy.midi_message3(144 + chan, pitch, vel);
+				}
+				pitch = p;
+				chan = c;
+				if ((!v) != (!vel)) {
+					daisy.midi_message3(144 + chan, pitch, v);
+				}
+				vel = v;
+			}
+
+			void update_pressure(GenDaisy& daisy, uint8_t pressure) {
+				if (vel && pressure != press) {
+					daisy.midi_message3(160 + chan, pitch, pressure);
+				}
+				press = pressure;
+			}
+		};
+
+		struct {
+			uint8_t status=0;
+			uint8_t lastbyte=0;
+			uint8_t byte[2];
+		} midi;
+
+		// midi input bytes from the control script, released as their time comes:
+		struct {
+			std::vector<uint8_t> data;
+			size_t readidx = 0, available = 0;
+
+			bool Readable() { return readidx < available; }
+			uint8_t PopRx() { return data[readidx++]; }
+		} uart;
+
+		uint8_t midi_in_written = 0;
+		uint8_t midi_in_active = 0;
+		float * midi_in_data = scratch[0];
+		size_t midi_out_bytes = 0;
+
+		void midi_postperform(float * buf, size_t size) {
+			for (size_t i=0; i<size && buf[i] >= 0.f; i++) midi_out_bytes++;
+		}
+
+		void midi_message1(uint8_t byte) { midi_out_bytes += 1; }
+		void midi_message2(uint8_t status, uint8_t b1) { midi_out_bytes += 2; }
+		void midi_message3(uint8_t status, uint8_t b1, uint8_t b2) { midi_out_bytes += 3; }
+		#endif //OOPSY_TARGET_USES_MIDI_UART
+
+		#ifdef OOPSY_USE_PRESETS
+		// presets are kept in RAM only, and applied at the next block boundary as on the Daisy:
+		std::vector<char> preset_cache[OOPSY_PRESET_SLOTS];
+		int preset_recall_slot = -1, preset_save_slot = -1;
+		int preset_morph_a = 0, preset_morph_b = 0, preset_morph_pending = 0;
+		float preset_morph_mix = 0.f;
+
+		void preset_recall(int slot) {
+			if (slot >= 0 && slot < OOPSY_PRESET_SLOTS) preset_recall_slot = slot;
+		}
+
+		void preset_save(int slot) {
+			if (slot >= 0 && slot < OOPSY_PRESET_SLOTS) preset_save_slot = slot;
+		}
+
+		void preset_morph(float position) {
+			if (position < 0.f) position = 0.f;
+			if (position > OOPSY_PRESET_SLOTS-1) position = OOPSY_PRESET_SLOTS-1;
+			preset_morph_a = int(position);
+			preset_morph_b = (preset_morph_a < OOPSY_PRESET_SLOTS-1) ? preset_morph_a+1 : preset_morph_a;
+			preset_morph_mix = position - preset_morph_a;
+			preset_morph_pending = 1;
+		}
+
+		template<typename T>
+		void preset_preperform(T& app) {
+			if (preset_save_slot >= 0) {
+				preset_cache[preset_save_slot].resize(OOPSY_PRESET_SIZE);
+				app.getstate(*this, preset_cache[preset_save_slot].data());
+				preset_save_slot = -1;
+			}
+			if (preset_recall_slot >= 0) {
+				if (preset_cache[preset_recall_slot].size()) app.setstate(*this, preset_cache[preset_recall_slot].data());
+				preset_recall_slot = -1;
+			}
+			if (preset_morph_pending) {
+				preset_morph_pending = 0;
+				std::vector<char>& a = preset_cache[preset_morph_a];
+				std::vector<char>& b = preset_cache[preset_morph_b];
+				if (a.size() && b.size()) app.morphstate(*this, a.data(), b.data(), preset_morph_mix);
+			}
+		}
+		#endif // OOPSY_USE_PRESETS
+
+		template<typename T>
+		void audio_preperform(T& app, size_t size) {
+			#ifdef OOPSY_TARGET_USES_MIDI_UART
+			for (size_t i=midi_in_written; i<size; i++) midi_in_data[i] = -0.1f;
+			midi_in_written = 0;
+			#endif
+			#ifdef OOPSY_USE_PRESETS
+			preset_preperform(app);
+			#endif
+		}
+
+		// there is only one app per render:
+		void schedule_app_load(int which) {}
+
+		GenDaisy& log(const char *fmt, ...) {
+			va_list argptr;
+			va_start(argptr, fmt);
+			vfprintf(stderr, fmt, argptr);
+			va_end(argptr);
+			fputc('\n', stderr);
+			return *this;
+		}
+
+		// the "sdcard" is the folder given by -d:
+		int sdcard_load_wav(const char * filename, Data& gendata) {
+			Wav wav;
+			std::string path = data_path + "/" + filename;
+			if (wav.read(path.c_str())) {
+				log("no %s", path.c_str());
+				return -1;
+			}
+			size_t frames = wav.frames < (size_t)gendata.dim ? wav.frames : gendata.dim;
+			for (size_t f=0; f<frames; f++) {
+				for (int c=0; c<gendata.channels; c++) {
+					gendata.mData[gendata.offset(f, c)] = wav.samples[f*wav.chans + (c % wav.chans)];
+				}
+			}
+			OOPSY_PROFILE_MARK(filename);
+			return frames;
+		}
+	};
+
+	// generated apps derive from this on the Daisy, for their static callbacks
+	// on the host they are called directly
+	template<typename T>
+	struct App {};
+
+	struct RenderJob {
+		const char * name;
+		float samplerate;
+		size_t blocksize;
+		// results:
+		int err;
+		size_t blocks;
+		double seconds, elapsed;
+		// the median, which is steadier than the mean when other processes interrupt:
+		double ns_per_block;
+		// how many times it was rendered, and how far the median repeat was from the fastest:
+		int repeats;
+		double ns_spread;
+		#ifdef OOPSY_PROFILE
+		std::string profile;
+		#endif
+	};
+
+	struct RenderOptions {
+		const Wav * input = nullptr;
+		const std::vector<ControlEvent> * events = nullptr;
+		const char * output_path = ".";
+		const char * data_path = ".";
+		double seconds = 10.;
+		// each job is rendered this many times, keeping the fastest, to steady the timings:
+		int repeats = 1;
+		// and until it has been timed for this long in total, so that short renders are repeated enough:
+		double min_seconds = 0.;
+	};
+
+	// renders one app at one samplerate and blocksize, timing only the generated code:
+	template<typename T>
+	void render(const RenderOptions& options, RenderJob& job) {
+		scratch_used = OOPSY_SCRATCH_RESERVED;
+		render_ticks = 0;
+		job.blocks = 0;
+		OOPSY_PROFILE_BEGIN();
+		#ifdef GENLIB_FLUSH_DENORMALS
+		// unlike the Daisy's interrupts, a thread keeps its FPU mode, so once per render is enough:
+		genlib_flush_denormals();
+		#endif
+		GenDaisy * daisy = new GenDaisy;
+		daisy->hardware = Daisy();
+		daisy->hardware.seed.samplerate = job.samplerate;
+		daisy->hardware.seed.blocksize = job.blocksize;
+		daisy->data_path = options.data_path;
+		genlib_sinetable();
+		OOPSY_PROFILE_MARK("sine table");
+		T * app = new T();
+		app->init(*daisy);
+		OOPSY_PROFILE_MARK("app init");
+
+		const Wav * input = options.input;
+		size_t frames = input ? input->frames : size_t(options.seconds * job.samplerate);
+		Wav output;
+		output.samplerate = job.samplerate;
+		output.chans = OOPSY_IO_COUNT;
+		output.frames = frames;
+		output.samples.resize(frames * OOPSY_IO_COUNT);
+
+		float inbufs[OOPSY_IO_COUNT][OOPSY_SCRATCH_STRIDE] __attribute__((aligned(32)));
+		float outbufs[OOPSY_IO_COUNT][OOPSY_SCRATCH_STRIDE] __attribute__((aligned(32)));
+		const float * ins[OOPSY_IO_COUNT];
+		float * outs[OOPSY_IO_COUNT];
+		for (int c=0; c<OOPSY_IO_COUNT; c++) {
+			ins[c] = inbufs[c];
+			outs[c] = outbufs[c];
+		}
+
+		size_t event = 0;
+		std::chrono::steady_clock::duration elapsed(0);
+		std::vector<double> block_ns;
+		block_ns.reserve(frames / job.blocksize + 1);
+		uint32_t dt = (uint32_t)(1000 * job.blocksize / job.samplerate);
+		for (size_t frame = 0; frame < frames; frame += job.blocksize) {
+			size_t size = (frames - frame) < job.blocksize ? (frames - frame) : job.blocksize;
+			double t = frame / job.samplerate;
+
+			// controls are sampled once per block, as they are on the Daisy:
+			if (options.events) {
+				const std::vector<ControlEvent>& events = *options.events;
+				for (; event < events.size() && events[event].time <= t; event++) {
+					const ControlEvent& e = events[event];
+					switch (e.kind) {
+						case ControlEvent::KNOB: daisy->hardware.knob[e.index] = e.value; break;
+						case ControlEvent::GATE: daisy->hardware.gate_in[e.index] = e.value; break;
+						case ControlEvent::MIDI:
+						#ifdef OOPSY_TARGET_USES_MIDI_UART
+							daisy->uart.data.insert(daisy->uart.data.end(), e.bytes, e.bytes + e.count);
+							daisy->uart.available = daisy->uart.data.size();
+						#endif
+							break;
+					}
+				}
+			}
+			for (int c=0; c<OOPSY_IO_COUNT; c++) {
+				float * buf = inbufs[c];
+				if (input) {
+					const float * src = input->samples.data() + frame*input->chans + (c % input->chans);
+					for (size_t i=0; i<size; i++) buf[i] = src[i*input->chans];
+				} else {
+					for (size_t i=0; i<size; i++) buf[i] = 0.f;
+				}
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			app->mainloopCallback(*daisy, uint32_t(t * 1000), dt);
+			daisy->audio_preperform(*app, size);
+			app->audioCallback(*daisy, ins, outs, size);
+			std::chrono::steady_clock::duration block = std::chrono::steady_clock::now() - start;
+			elapsed += block;
+			block_ns.push_back(std::chrono::duration<double, std::nano>(block).count());
+			daisy->blockcount++;
+			#ifdef OOPSY_PROFILE
+			if (!job.blocks) {
+				profile.mark("first block");
+				// the report is for loading, not for the gen~ resets during the render:
+				profile.reported = 1;
+			}
+			#endif
+			job.blocks++;
+
+			for (int c=0; c<OOPSY_IO_COUNT; c++) {
+				float * dst = output.samples.data() + frame*OOPSY_IO_COUNT + c;
+				for (size_t i=0; i<size; i++) dst[i*OOPSY_IO_COUNT] = outs[c][i];
+			}
+		}
+		job.seconds = frames / job.samplerate;
+		job.elapsed = std::chrono::duration<double>(elapsed).count();
+		std::nth_element(block_ns.begin(), block_ns.begin() + block_ns.size()/2, block_ns.end());
+		job.ns_per_block = block_ns.size() ? block_ns[block_ns.size()/2] : 0.;
+		delete app;
+		delete daisy;
+		#ifdef OOPSY_PROFILE
+		job.profile.clear();
+		char line[64];
+		for (int i=0; profile.line(i, line, sizeof(line)); i++) job.profile += std::string("\t") + line + "\n";
+		#endif
+
+		char path[1024];
+		snprintf(path, sizeof(path), "%s/%s_%d_%d.wav", options.output_path, job.name, int(job.samplerate), int(job.blocksize));
+		job.err = output.write(path);
+		if (job.err) fprintf(stderr, "couldn't write %s\n", path);
+	}
+
+	struct AppDef {
+		const char * name;
+		void (*render)(const RenderOptions& options, RenderJob& job);
+	};
+
+	// parses a comma-separated list of numbers
+	std::vector<float> parse_list(const char * s) {
+		std::vector<float> list;
+		while (s && *s) {
+			list.push_back(atof(s));
+			s = strchr(s, ',');
+			if (s) s++;
+		}
+		return list;
+	}
+
+	// usage: <binary> [-i input.wav] [-s script.txt] [-o outdir] [-d datadir] [-l seconds]
+	//                 [-r samplerate,...] [-b blocksize,...] [-j threads] [-n repeats] [-t min ms]
+	int host_main(int argc, char ** argv, AppDef * appdefs, int app_count) {
+		RenderOptions options;
+		Wav input;
+		std::vector<ControlEvent> events;
+		std::vector<float> samplerates = { OOPSY_SAMPLERATE };
+		std::vector<float> blocksizes = { OOPSY_BLOCK_SIZE };
+		unsigned threads = std::thread::hardware_concurrency();
+		for (int i=1; i+1<argc; i+=2) {
+			const char * arg = argv[i+1];
+			switch (argv[i][1]) {
+				case 'i': {
+					if (input.read(arg)) { fprintf(stderr, "couldn't read %s\n", arg); return -1; }
+					options.input = &input;
+				} break;
+				case 's': {
+					if (read_control_script(arg, events)) { fprintf(stderr, "couldn't read %s\n", arg); return -1; }
+					options.events = &events;
+				} break;
+				case 'o': options.output_path = arg; break;
+				case 'd': options.data_path = arg; break;
+				case 'l': options.seconds = atof(arg); break;
+				case 'r': samplerates = parse_list(arg); break;
+				case 'b': blocksizes = parse_list(arg); break;
+				case 'j': threads = atoi(arg); break;
+				case 'n': options.repeats = atoi(arg) > 1 ? atoi(arg) : 1; break;
+				case 't': options.min_seconds = atof(arg) / 1000.; break;
+				default: fprintf(stderr, "unexpected argument %s\n", argv[i]); return -1;
+			}
+		}
+
+		std::vector<RenderJob> jobs;
+		for (int a=0; a<app_count; a++) {
+			for (float samplerate : samplerates) {
+				for (float blocksize : blocksizes) {
+					if (blocksize < 1 || blocksize > OOPSY_BLOCK_SIZE) {
+						fprintf(stderr, "block size %d must be between 1 and %d\n", int(blocksize), OOPSY_BLOCK_SIZE);
+						return -1;
+					}
+					jobs.push_back({ appdefs[a].name, samplerate, size_t(blocksize) });
+				}
+			}
+		}
+
+		// each worker takes the next job until none are left, so that all cores stay busy:
+		std::atomic<size_t> next(0);
+		std::mutex report;
+		auto worker = [&]() {
+			for (size_t j = next++; j < jobs.size(); j = next++) {
+				RenderJob& job = jobs[j];
+				double fastest = 0., total = 0.;
+				std::vector<double> repeat_ns;
+				for (int r=0; r<options.repeats || total < options.min_seconds; r++) {
+					appdefs[(j / (samplerates.size() * blocksizes.size()))].render(options, job);
+					if (!r || job.elapsed < fastest) fastest = job.elapsed;
+					total += job.elapsed;
+					repeat_ns.push_back(job.ns_per_block);
+					if (job.err) break;
+				}
+				std::sort(repeat_ns.begin(), repeat_ns.end());
+				job.elapsed = fastest;
+				job.repeats = int(repeat_ns.size());
+				job.ns_per_block = repeat_ns[0];
+				job.ns_spread = repeat_ns[repeat_ns.size()/2] - repeat_ns[0];
+				std::lock_guard<std::mutex> lock(report);
+				printf("%s %dHz block %d: %.2fs in %.3fs, %.1fx realtime, %.0f ns/block\n",
+					job.name, int(job.samplerate), int(job.blocksize), job.seconds, job.elapsed,
+					job.seconds / job.elapsed, job.ns_per_block);
+				#ifdef OOPSY_PROFILE
+				// (from the last repeat, once the caches are warm)
+				printf("%s", job.profile.c_str());
+				#endif
+				fflush(stdout);
+			}
+		};
+		if (threads < 1) threads = 1;
+		if (threads > jobs.size()) threads = jobs.size();
+		std::vector<std::thread> pool;
+		for (unsigned t=0; t<threads; t++) pool.emplace_back(worker);
+		for (std::thread& t : pool) t.join();
+
+		// a summary for scripts:
+		char path[1024];
+		snprintf(path, sizeof(path), "%s/render.json", options.output_path);
+		FILE * f = fopen(path, "w");
+		if (!f) return -1;
+		fprintf(f, "[");
+		int err = 0;
+		for (size_t j=0; j<jobs.size(); j++) {
+			RenderJob& job = jobs[j];
+			fprintf(f, "%s\n\t{ \"app\": \"%s\", \"samplerate\": %d, \"blocksize\": %d, \"seconds\": %f, \"elapsed\": %f, \"realtime\": %f, \"ns_per_block\": %f, \"ns_spread\": %f, \"repeats\": %d, \"file\": \"%s_%d_%d.wav\" }",
+				j ? "," : "", job.name, int(job.samplerate), int(job.blocksize), job.seconds, job.elapsed,
+				job.seconds / job.elapsed, job.ns_per_block, job.ns_spread, job.repeats,
+				job.name, int(job.samplerate), int(job.blocksize));
+			err |= job.err;
+		}
+		fprintf(f, "\n]\n");
+		fclose(f);
+		return err;
+	}
+
+}; // oopsy::
+
+void genlib_report_error(const char *s) { fprintf(stderr, "%s\n", s); }
+void genlib_report_message(const char *s) { fprintf(stderr, "%s\n", s); }
+
+unsigned long genlib_ticks() {
+	return ++oopsy::render_ticks;
+}
+
+t_ptr genlib_sysmem_newptr(t_ptr_size size) {
+	return (t_ptr)calloc(1, size);
+}
+
+t_ptr genlib_sysmem_newptrclear(t_ptr_size size) {
+	OOPSY_PROFILE_START(start);
+	t_ptr p = (t_ptr)calloc(1, size);
+	OOPSY_PROFILE_ADD("zero memory", start);
+	return p;
+}
+
+#endif //GENLIB_HOST_H
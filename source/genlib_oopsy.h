@@ -0,0 +1,297 @@
+#ifndef GENLIB_OOPSY_H
+#define GENLIB_OOPSY_H
+
+/*
+Oopsy was authored in 2020-2021 by Graham Wakefield.  Copyright 2021 Electrosmith, Corp. and Graham Wakefield.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+	The parts of the oopsy runtime that the generated App code uses on every target,
+	included by both genlib_daisy.h and genlib_host.h
+
+	Before including it, the target defines:
+	- OOPSY_SCRATCH_STORAGE, qualifying the scratch arena (e.g. OOPSY_DTCM on the Daisy, thread_local on the host)
+	- with OOPSY_PROFILE, OOPSY_PROFILE_NOW(), a timestamp in microseconds, 
+	  and optionally OOPSY_PROFILE_STORAGE, qualifying the profile (e.g. thread_local on the host)
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h> // snprintf
+
+namespace oopsy {
+
+	// block buffers for the generated code (glue outs etc.), in one arena shared by all apps
+	// oopsy.js sizes the arena for the app that needs the most buffers
+	// each buffer is aligned to the 32 byte cache lines of the M7
+	#ifdef OOPSY_TARGET_USES_MIDI_UART
+	#define OOPSY_SCRATCH_RESERVED (1) // midi input data
+	#else
+	#define OOPSY_SCRATCH_RESERVED (0)
+	#endif
+	#ifndef OOPSY_SCRATCH_COUNT
+	#define OOPSY_SCRATCH_COUNT (OOPSY_SCRATCH_RESERVED + 1)
+	#endif
+	#define OOPSY_SCRATCH_STRIDE ((OOPSY_BLOCK_SIZE + 7) & ~7)
+	OOPSY_SCRATCH_STORAGE float scratch[OOPSY_SCRATCH_COUNT][OOPSY_SCRATCH_STRIDE] __attribute__((aligned(32)));
+	OOPSY_SCRATCH_STORAGE uint32_t scratch_used = OOPSY_SCRATCH_RESERVED;
+
+	// buffers are handed out as an app initializes, and all returned when the next app loads
+	// (running out means oopsy.js miscounted the app's buffers)
+	float * scratch_buffer() {
+		if (scratch_used >= OOPSY_SCRATCH_COUNT) {
+			genlib_report_error("scratch: out of buffers");
+			return nullptr;
+		}
+		return scratch[scratch_used++];
+	}
+
+	#ifdef OOPSY_PROFILE
+	// timestamps of the phases of booting and of loading an app, up to its first audio callback,
+	// reported on the console (and over USB serial with OOPSY_USE_LOGGING) once audio is running
+	// phases are marked in sequence; totals (such as memory zeroing) accumulate across phases
+	#ifndef OOPSY_PROFILE_STORAGE
+	#define OOPSY_PROFILE_STORAGE
+	#endif
+	#ifndef OOPSY_PROFILE_PHASES
+	#define OOPSY_PROFILE_PHASES (24)
+	#endif
+	struct Profile {
+		struct Phase {
+			const char * name;
+			uint32_t us;
+		};
+		Phase phases[OOPSY_PROFILE_PHASES], totals[4];
+		int phase_count = 0, total_count = 0;
+		uint32_t start = 0, last = 0;
+		// set when an app is installed, cleared by its first audio callback
+		volatile int waiting = 0;
+		int reported = 0;
+
+		uint32_t now() { return OOPSY_PROFILE_NOW(); }
+
+		void begin() {
+			phase_count = total_count = 0;
+			start = last = now();
+			waiting = reported = 0;
+		}
+
+		void mark(const char * name) {
+			uint32_t t = now();
+			if (phase_count < OOPSY_PROFILE_PHASES) phases[phase_count++] = { name, t - last };
+			last = t;
+		}
+
+		void add(const char * name, uint32_t us) {
+			// (ignoring anything after the report, e.g. a gen~ reset while running)
+			if (reported) return;
+			for (int i=0; i<total_count; i++) {
+				if (totals[i].name == name) { totals[i].us += us; return; }
+			}
+			if (total_count < 4) totals[total_count++] = { name, us };
+		}
+
+		// writes line i of the report, returning false after the last:
+		bool line(int i, char * buf, int len) {
+			if (i < phase_count) {
+				format(buf, len, "", phases[i]);
+			} else if (i < phase_count + total_count) {
+				format(buf, len, "+", totals[i - phase_count]);
+			} else if (i == phase_count + total_count) {
+				format(buf, len, "", { "total", last - start });
+			} else {
+				return false;
+			}
+			return true;
+		}
+
+		// as ms with one decimal, since printf may not support floats:
+		void format(char * buf, int len, const char * prefix, const Phase& p) {
+			snprintf(buf, len, "%s%.12s %lu.%lums", prefix, p.name, (unsigned long)(p.us/1000), (unsigned long)((p.us/100)%10));
+		}
+	};
+	OOPSY_PROFILE_STORAGE Profile profile;
+	#define OOPSY_PROFILE_BEGIN() oopsy::profile.begin()
+	#define OOPSY_PROFILE_MARK(name) oopsy::profile.mark(name)
+	#define OOPSY_PROFILE_START(var) uint32_t var = oopsy::profile.now()
+	#define OOPSY_PROFILE_ADD(name, var) oopsy::profile.add(name, oopsy::profile.now() - var)
+	#else
+	#define OOPSY_PROFILE_BEGIN()
+	#define OOPSY_PROFILE_MARK(name)
+	#define OOPSY_PROFILE_START(var)
+	#define OOPSY_PROFILE_ADD(name, var)
+	#endif // OOPSY_PROFILE
+
+	// a control input (knob, CV etc.) as an audio-rate signal for a gen~ [in]
+	// controls are only sampled once per block, so each block ramps linearly from the previous value,
+	// which removes the staircase at the cost of one block of latency
+	struct CvStream {
+		float * data;
+		float prev;
+
+		void init() {
+			data = scratch_buffer();
+			prev = 0.f;
+		}
+
+		float * process(float value, size_t size) {
+			float step = (value - prev) / size;
+			for (size_t i=0; i<size; i++) data[i] = prev + step*(i+1);
+			prev = value;
+			return data;
+		}
+	};
+
+	// poly<N> apps run N instances of the gen~ patch, and hand MIDI notes to them.
+	// Notes arrive in the main loop, and are allocated at the start of the next block. 
+	// A voice is performed from its note on until it is released and its outs stay 
+	// below OOPSY_VOICE_SILENCE for OOPSY_VOICE_SILENT_BLOCKS blocks in a row.
+	#ifndef OOPSY_VOICE_SILENCE
+	#define OOPSY_VOICE_SILENCE (0.0001f) // -80dB
+	#endif
+	#ifndef OOPSY_VOICE_SILENT_BLOCKS
+	#define OOPSY_VOICE_SILENT_BLOCKS (8)
+	#endif
+	#define OOPSY_VOICE_EVENTS (16)
+	template<int VOICES>
+	struct Voices {
+		struct Voice {
+			float pitch, vel, gate, peak;
+			uint32_t stamp; // when its current note began
+			uint8_t active, silent;
+		} voice[VOICES];
+		// note events from the main loop to the audio callback:
+		uint8_t events[OOPSY_VOICE_EVENTS][2];
+		volatile uint8_t event_write, event_read;
+		uint32_t clock;
+		int newest;
+
+		void init() {
+			for (int v=0; v<VOICES; v++) {
+				voice[v].pitch = 60.f;
+				voice[v].vel = voice[v].gate = voice[v].peak = 0.f;
+				voice[v].stamp = 0;
+				voice[v].active = voice[v].silent = 0;
+			}
+			event_write = event_read = 0;
+			clock = 0;
+			newest = 0;
+		}
+
+		// from the main loop, with vel 0 for a note off:
+		void note(uint8_t pitch, uint8_t vel) {
+			uint8_t next = (event_write + 1) % OOPSY_VOICE_EVENTS;
+			if (next == event_read) return; // full, drop it
+			events[event_write][0] = pitch;
+			events[event_write][1] = vel;
+			event_write = next;
+		}
+
+		// at the start of each audio block:
+		void update() {
+			while (event_read != event_write) {
+				uint8_t pitch = events[event_read][0], vel = events[event_read][1];
+				event_read = (event_read + 1) % OOPSY_VOICE_EVENTS;
+				if (vel) {
+					note_on(pitch, vel);
+				} else {
+					for (int v=0; v<VOICES; v++) if (voice[v].gate > 0.f && voice[v].pitch == pitch) voice[v].gate = 0.f;
+				}
+			}
+		}
+
+		void note_on(uint8_t pitch, uint8_t vel) {
+			// the voice already holding this note, else a free voice, 
+			// else the quietest released voice, else the oldest held voice:
+			int w = -1;
+			for (int v=0; v<VOICES && w<0; v++) if (voice[v].active && voice[v].gate > 0.f && voice[v].pitch == pitch) w = v;
+			for (int v=0; v<VOICES && w<0; v++) if (!voice[v].active) w = v;
+			if (w < 0) {
+				for (int v=0; v<VOICES; v++) if (voice[v].gate == 0.f && (w < 0 || voice[v].peak < voice[w].peak)) w = v;
+			}
+			if (w < 0) {
+				w = 0;
+				for (int v=1; v<VOICES; v++) if (voice[w].stamp - voice[v].stamp < 0x80000000u) w = v;
+			}
+			Voice& o = voice[w];
+			o.pitch = pitch;
+			o.vel = vel/127.f;
+			o.gate = 1.f;
+			o.active = 1;
+			o.silent = 0;
+			o.stamp = ++clock;
+			newest = w;
+		}
+
+		// after each voice has performed, with the peak level of its audio outs:
+		void settle(int v, float peak) {
+			Voice& o = voice[v];
+			o.peak = peak;
+			if (o.gate > 0.f || peak >= OOPSY_VOICE_SILENCE) {
+				o.silent = 0;
+			} else if (++o.silent >= OOPSY_VOICE_SILENT_BLOCKS) {
+				o.active = 0;
+			}
+		}
+	};
+
+	// apps built with the idle option stop performing gen~ once their audio ins and outs 
+	// have stayed below OOPSY_IDLE_THRESHOLD for the hold time, writing silence instead, 
+	// and perform again from the first block in which an audio in rises above it.
+	#ifndef OOPSY_IDLE_THRESHOLD
+	#define OOPSY_IDLE_THRESHOLD (0.0001f) // -80dB
+	#endif
+	#ifndef OOPSY_IDLE_HOLD_MS
+	#define OOPSY_IDLE_HOLD_MS (2000)
+	#endif
+	struct Idle {
+		uint32_t hold, quiet;
+		int asleep;
+
+		void init(uint32_t hold_samples) {
+			hold = hold_samples;
+			quiet = 0;
+			asleep = 0;
+		}
+
+		// before perform: true if gen~ should run this block
+		bool wake(float ** ins, int count, size_t size) {
+			if (!asleep) return true;
+			for (int c=0; c<count; c++) {
+				const float * buf = ins[c];
+				for (size_t i=0; i<size; i++) {
+					if (fabsf(buf[i]) > OOPSY_IDLE_THRESHOLD) {
+						asleep = 0;
+						quiet = 0;
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		// after perform, with its ins and outs:
+		void settle(float ** bufs, int count, size_t size) {
+			for (int c=0; c<count; c++) {
+				const float * buf = bufs[c];
+				for (size_t i=0; i<size; i++) {
+					if (fabsf(buf[i]) > OOPSY_IDLE_THRESHOLD) {
+						quiet = 0;
+						return;
+					}
+				}
+			}
+			quiet += size;
+			if (quiet >= hold) asleep = 1;
+		}
+	};
+
+} // oopsy::
+
+#endif // GENLIB_OOPSY_H
@@ -37,7 +37,48 @@ const fs = require("fs"),
 	path = require("path"),
 	os = require("os"),
 	assert = require("assert");
-const {exec, execSync, spawn} = require("child_process");
+const {exec, execSync, execFileSync, spawn} = require("child_process");
+
+// preset storage, matching genlib_daisy.h:
+const PRESET_SLOTS = 8
+const PRESET_RECORD_HEADER = 16
+const PRESET_BANK_SIZE = 65536
+// [data] up to this many samples are included in preset snapshots:
+const PRESET_DATA_MAX = 256
+
+// fastmath approximations can be chosen per function, matching GENLIB_FASTMATH_* in genlib.h:
+const fastmath_functions = ["sin", "cos", "tan", "exp", "log2", "pow", "atan2", "tanh"]
+const fastmath_tiers = ["exact", "fast", "faster"]
+
+// the linker script fragment for the tcm option, inserted into libdaisy's own
+// (ld warns that the memory regions are not yet declared, as they are declared by libdaisy's script):
+// ITCM code is loaded from flash, and DTCM is zeroed, by oopsy_tcm_init() in genlib_daisy.h
+const tcm_linker_script = `/* generated by oopsy.js for the tcm option */
+SECTIONS
+{
+	.oopsy_itcm :
+	{
+		. = ALIGN(4);
+		_oopsy_itcm_start = .;
+		/* ITCM starts at address 0, and no function should have a null address: */
+		. = . + 8;
+		*(.oopsy_itcm)
+		. = ALIGN(4);
+		_oopsy_itcm_end = .;
+	} > ITCMRAM AT> FLASH
+	_oopsy_itcm_load = LOADADDR(.oopsy_itcm);
+
+	.oopsy_dtcm (NOLOAD) :
+	{
+		. = ALIGN(32);
+		_oopsy_dtcm_start = .;
+		*(.oopsy_dtcm)
+		. = ALIGN(4);
+		_oopsy_dtcm_end = .;
+	} > DTCMRAM
+}
+INSERT AFTER .data;
+`
 
 // returns the path `str` with posix path formatting:
 function posixify_path(str) {
@@ -123,6 +164,11 @@ const help = `
 
 cmds: 	up/upload = (default) generate & upload
 	  	gen/generate = generate only
+		render = build for this computer, and render each app to WAV files faster than real time
+			an input .wav and a control script .txt can be given
+			several samplerates & block sizes can be given, all combinations will be rendered
+			repeat3, repeat5, repeat10 render each several times, reporting the fastest
+			repeat<N>ms (e.g. repeat200ms) also repeats each until it has been timed for at least N ms in total
 
 target: path to a JSON for the hardware config, 
 		or simply "patch", "patch_sm", "field", "petal", "pod" etc. 
@@ -133,11 +179,44 @@ target: path to a JSON for the hardware config,
 block1, block2, etc. up to block256 will set the block size
 
 fastmath will replace some expensive math operations with faster approximations
+fastmath=<functions> chooses approximations per function, e.g. fastmath=tanh,exp:fast
+		functions are sin, cos, tan, exp, log2, pow, atan2, tanh, or all
+		tiers are exact, fast (errors from about 1e-7 to 1e-4, see genlib_bench.cpp) or faster (the default, as for fastmath)
+
+sinetable8, sinetable10, sinetable12 will use a smaller sine table (in flash) for cycle, with cubic interpolation
+
+ftz will flush denormals to zero in the FPU, and skip gen~'s per-sample denormal checks
+
+fixedphasor will use a 32-bit fixed-point phase for phasor, which does not drift in float32
+
+planar will store each channel of multichannel [data] contiguously rather than interleaved
+(or name a [data] with a "planar" word, e.g. [data loops_planar 48000 8], for just that one)
+
+profile will time each phase of booting and of loading an app, and show them on the console
+(and over USB serial with logging; with render, they are printed for each render)
+
+tcm will run the audio callback (with gen~'s perform inlined into it) from ITCM, 
+and put gen~ State and small buffers in DTCM; the build prints what was placed there
+
+oversample2, oversample4 will run the gen~ patch named before it at 2x or 4x the samplerate,
+undersample2 at half the samplerate (or every patch, if it comes before them all)
+		audio is resampled through halfband filters, other signals are held or picked
+
+poly<N> (e.g. poly8) will run N instances of the gen~ patch named before it (or every patch),
+		handing each MIDI note to a voice, and summing their outs; 
+		params named voice_pitch, voice_vel and voice_gate are set per voice
+
+idle will stop running the gen~ patch named before it (or every patch) 
+		once its audio ins and outs have been silent for 2 seconds (or idle=<ms>), 
+		until audio comes in again
 
 boost will increase the CPU from 400Mhz to 480Mhz
 
 nooled will disable code generration for OLED (it will be blank)
 
+serial will chain all cpps into a single app, each feeding the next (in argument order)
+parallel will run all cpps as a single app, summing their outputs
+
 cpps: 	paths to the gen~ exported cpp files
 		first item will be the default app
 		  
@@ -152,8 +231,9 @@ const component_defs = {
 		type: "daisy::Switch::TYPE_MOMENTARY",
 		polarity: "daisy::Switch::POLARITY_INVERTED",
 		pull: "daisy::Switch::PULL_UP",
+		divisible: true,
 		process: "${name}.Debounce();",
-		updaterate: "${name}.SetUpdateRate(seed.AudioCallbackRate());",
+		updaterate: "${name}.SetUpdateRate(${rate});",
 		mapping: [
 			{ name: "${name}", get: "(hardware.${name}.Pressed()?1.f:0.f)", range: [0, 1] },
 			{
@@ -227,8 +307,9 @@ const component_defs = {
 		flip: false,
 		invert: false,
 		slew: "1.0/seed.AudioCallbackRate()",
+		divisible: true,
 		process: "${name}.Process();",
-		updaterate: "${name}.SetSampleRate(seed.AudioCallbackRate());",
+		updaterate: "${name}.SetSampleRate(${rate});",
 		mapping: [{ name: "${name}", get: "(hardware.${name}.Value())", range: [0, 1] }]
 	},
 	Led: {
@@ -282,8 +363,33 @@ const component_defs = {
 	}
 };
 
-// generate the struct
-function generate_target_struct(target) {
+// components processed less often than every block are spread across successive blocks
+// returns the number of blocks in the schedule's cycle, and sets the phase of each component
+function schedule_components(components) {
+	const gcd = (a, b) => b ? gcd(b, a % b) : a
+	const scheduled = components.filter(e => e.process && e.divisor > 1)
+	const cycle = scheduled.reduce((cycle, e) => cycle * e.divisor / gcd(cycle, e.divisor), 1)
+	// how many components are processed in each block of the cycle:
+	let load = new Array(cycle).fill(0)
+	// place the least frequent components last, as they are the easiest to fit in:
+	scheduled.sort((a, b) => a.divisor - b.divisor).forEach(e => {
+		let best, bestload = Infinity
+		for (let phase = 0; phase < e.divisor; phase++) {
+			let worst = 0
+			for (let c = phase; c < cycle; c += e.divisor) worst = Math.max(worst, load[c])
+			if (worst < bestload) {
+				best = phase
+				bestload = worst
+			}
+		}
+		e.phase = best
+		for (let c = best; c < cycle; c += e.divisor) load[c]++
+	})
+	return cycle
+}
+
+// flesh out the target's components with their component_defs
+function configure_target_components(target) {
 	
 	// flesh out target components:
 	let components = Object.entries(target.components)
@@ -307,6 +413,13 @@ function generate_target_struct(target) {
 		} else {
 		  throw new Error("undefined component kind: " + def.component);
 		}
+		// unless specified, process controls every block:
+		if (def.divisor == undefined) def.divisor = 1;
+		if (def.divisor > 1 && !def.divisible) {
+			console.warn(`oopsy warning: component ${name} cannot have an update divisor`)
+			def.divisor = 1
+		}
+		def.rate = def.divisor > 1 ? `seed.AudioCallbackRate()/${def.divisor}` : `seed.AudioCallbackRate()`
 		return def;
 	});
 	target.components = components;
@@ -323,7 +436,35 @@ function generate_target_struct(target) {
 		target.defines.OOPSY_OLED_DISPLAY_WIDTH = target.display.dim[0]
 		target.defines.OOPSY_OLED_DISPLAY_HEIGHT = target.display.dim[1]
 	}
-  
+}
+
+// names of the components that are mapped to some app's params or outs, drive the menu, or are referred to by the target's inserts:
+function used_components(hardware, apps) {
+	let used = new Set(hardware.components.filter(e => e.meta).map(e => e.name))
+	const inserts = (hardware.inserts || []).map(o => o.code).join("\n")
+	hardware.components.filter(e => new RegExp(`\\b${e.name}\\b`).test(inserts)).forEach(e => used.add(e.name))
+	apps.forEach(app => {
+		app.daisy.device_inputs.map(name => app.nodes[name])
+			.filter(node => node.to.length && node.component)
+			.forEach(node => used.add(node.component))
+		app.daisy.device_outs.map(name => app.nodes[name])
+			.filter(node => (node.src || node.from.length) && node.config.component)
+			.forEach(node => used.add(node.config.component))
+	})
+	return used
+}
+
+// generate the struct
+// components that are not used are still declared, but are not processed, 
+// and only outputs are initialized (so that they are driven low rather than left floating)
+function generate_target_struct(target, used) {
+	const components = target.components.filter(e => used.has(e.name))
+	const outputs = ["daisy::Led", "daisy::RgbLed", "daisy::dsy_gpio", "daisy::DacHandle::Config"]
+	const initialized = target.components.filter(e => used.has(e.name) || outputs.includes(e.typename))
+	const analogs = components.filter((e) => e.typename == "daisy::AnalogControl")
+	const cycle = schedule_components(components);
+	// with no channels configured, the ADC must not be started:
+	if (!analogs.length) target.defines.OOPSY_NO_ADC = 1
 	return `
 #include "daisy_seed.h"
 ${target.display ? `#include "dev/oled_ssd130x.h"` : ""}
@@ -339,7 +480,7 @@ struct Daisy {
 		).join("")}
 		${components.filter((e) => e.typename == "daisy::Switch")
 		.map((e, i) => `
-		${e.name}.Init(seed.GetPin(${e.pin}), seed.AudioCallbackRate(), ${e.type}, ${e.polarity}, ${e.pull});`
+		${e.name}.Init(seed.GetPin(${e.pin}), ${e.rate}, ${e.type}, ${e.polarity}, ${e.pull});`
 		).join("")}
 		${components.filter((e) => e.typename == "daisy::Switch3").map((e, i) => `
 		${e.name}.Init(seed.GetPin(${e.pin.a}), seed.GetPin(${e.pin.b}));`
@@ -351,26 +492,29 @@ struct Daisy {
 		${components.filter((e) => e.typename == "daisy::Encoder").map((e, i) => `
 		${e.name}.Init(seed.GetPin(${e.pin.a}), seed.GetPin(${e.pin.b}), seed.GetPin(${e.pin.click}), seed.AudioCallbackRate());`
 		).join("")}
-		static const int ANALOG_COUNT = ${
-		components.filter((e) => e.typename == "daisy::AnalogControl").length};
+		${analogs.length ? `
+		static const int ANALOG_COUNT = ${analogs.length};
 		daisy::AdcChannelConfig cfg[ANALOG_COUNT];
-		${components.filter((e) => e.typename == "daisy::AnalogControl").map((e, i) => `
+		${analogs.map((e, i) => `
 		cfg[${i}].InitSingle(seed.GetPin(${e.pin}));`).join("")}
 		seed.adc.Init(cfg, ANALOG_COUNT);
-		${components.filter((e) => e.typename == "daisy::AnalogControl").map((e, i) => `
-		${e.name}.Init(seed.adc.GetPtr(${i}), seed.AudioCallbackRate(), ${e.flip}, ${e.invert});`).join("")}
-		${components.filter((e) => e.typename == "daisy::Led").map((e, i) => `
+		${analogs.map((e, i) => `
+		${e.name}.Init(seed.adc.GetPtr(${i}), ${e.rate}, ${e.flip}, ${e.invert});`).join("")}` : `// no analog controls used`}
+		${initialized.filter((e) => e.typename == "daisy::Led").map((e, i) => `
 		${e.name}.Init(seed.GetPin(${e.pin}), ${e.invert});
-		${e.name}.Set(0.0f);`).join("")}	
-	  	${components.filter((e) => e.typename == "daisy::RgbLed").map((e, i) => `
+		${e.name}.Set(0.0f);
+		${e.name}.Update();`).join("")}	
+	  	${initialized.filter((e) => e.typename == "daisy::RgbLed").map((e, i) => `
 		${e.name}.Init(seed.GetPin(${e.pin.r}), seed.GetPin(${e.pin.g}), seed.GetPin(${e.pin.b}), ${e.invert});
-		${e.name}.Set(0.0f, 0.0f, 0.0f);`).join("")}
-		${components.filter((e) => e.typename == "daisy::dsy_gpio").map((e, i) => `
+		${e.name}.Set(0.0f, 0.0f, 0.0f);
+		${e.name}.Update();`).join("")}
+		${initialized.filter((e) => e.typename == "daisy::dsy_gpio").map((e, i) => `
 		${e.name}.pin  = seed.GetPin(${e.pin});
 		${e.name}.mode = ${e.mode};
 		${e.name}.pull = ${e.pull};
-		dsy_gpio_init(&${e.name});`).join("")}
-		${components.filter((e) => e.typename == "daisy::DacHandle::Config").map((e, i) => `
+		dsy_gpio_init(&${e.name});
+		dsy_gpio_write(&${e.name}, 0);`).join("")}
+		${initialized.filter((e) => e.typename == "daisy::DacHandle::Config").map((e, i) => `
 		${e.name}.bitdepth   = ${e.bitdepth};
 		${e.name}.buff_state = ${e.buff_state};
 		${e.name}.mode       = ${e.mode};
@@ -385,8 +529,14 @@ struct Daisy {
 	}
   
 	void ProcessAllControls() {
-		${components.filter((e) => e.process).map((e) => `
+		${components.filter((e) => e.process && e.divisor == 1).map((e) => `
 		${template(e.process, e)}`).join("")}
+		${cycle > 1 ? `
+		// components with an update divisor are processed on a rotating schedule:
+		switch (control_phase) {${new Array(cycle).fill(0).map((_, c) => `
+		case ${c}:${components.filter((e) => e.process && e.divisor > 1 && c % e.divisor == e.phase).map((e) => ` ${template(e.process, e)}`).join("")} break;`).join("")}
+		}
+		control_phase = (control_phase + 1) % ${cycle};` : ""}
 		${components.filter((e) => e.meta).map((e) => e.meta.map(m=>`
 		${template(m, e)}`).join("")).join("")}
 	}
@@ -417,10 +567,11 @@ struct Daisy {
 	}
   
 	daisy::DaisySeed seed;
-	${components.map((e) => `
+	${target.components.map((e) => `
 	${e.typename} ${e.name};`).join("")}
 	${target.display ? `daisy::OledDisplay<${target.display.driver}> display;`:`// no display`}
 	int menu_click = 0, menu_hold = 0, menu_rotate = 0;
+	int control_phase = 0;
 
 };`;
 }
@@ -442,12 +593,19 @@ function run() {
 	let target_path
 	let watch = false
 	let cpps = []
+	// oversample/undersample factors per cpp:
+	let cpp_rates = {}
+	// poly voice counts per cpp:
+	let cpp_voices = {}
+	// idle hold times per cpp (true for the default):
+	let cpp_idles = {}
 	let samplerate = 48
 	let blocksize = 48
 	let options = {}
+	// render can run several configurations at once:
+	let samplerates = []
+	let blocksizes = []
 
-	checkBuildEnvironment();
-	
 	if (args.length == 0) {
 		console.log(help)
 		return;
@@ -460,6 +618,7 @@ function run() {
 			case "gen": action="generate"; break;
 			case "upload":
 			case "up": action="upload"; break;
+			case "render": action="render"; target="host"; break;
 
 			case "pod":
 			case "field":
@@ -474,7 +633,7 @@ function run() {
 
 			case "96kHz": 
 			case "48kHz": 
-			case "32kHz": samplerate = +(arg.match(/(\d+)kHz/)[1]); break; 
+			case "32kHz": samplerate = +(arg.match(/(\d+)kHz/)[1]); samplerates.push(samplerate); break; 
 
 			case "block1":
 			case "block2":
@@ -489,14 +648,84 @@ function run() {
 			case "block64": 
 			case "block96": 
 			case "block128":
-			case "block256": blocksize = +(arg.match(/block(\d+)/)[1]); break;
+			case "block256": blocksize = +(arg.match(/block(\d+)/)[1]); blocksizes.push(blocksize); break;
 
 			case "writejson":
 			case "nooled": 
 			case "boost": 
+			case "ftz":
+			case "fixedphasor":
+			case "planar":
+			case "profile":
+			case "tcm":
 			case "fastmath": options[arg] = true; break;
 
+			case "sinetable8":
+			case "sinetable10":
+			case "sinetable12": options.sinetable = +(arg.match(/sinetable(\d+)/)[1]); break;
+
+			case "serial":
+			case "parallel": options.chain = arg; break;
+
+			case "oversample2":
+			case "oversample4":
+			case "undersample2": {
+				// applies to the cpp named before it, or to every app if it comes before any cpp:
+				const rate = arg.startsWith("over") ? +arg.slice(-1) : 1/+arg.slice(-1)
+				if (cpps.length) cpp_rates[cpps[cpps.length-1]] = rate
+				else options.rate = rate
+			} break;
+
+			case "repeat3":
+			case "repeat5":
+			case "repeat10": options.repeats = +(arg.match(/repeat(\d+)/)[1]); break;
+
 			default: {
+				// idle bypass, e.g. idle or idle=5000 (ms), for the cpp named before it or every app:
+				let match = arg.match(/^idle(=(\d+))?$/)
+				if (match) {
+					const hold = match[2] !== undefined ? +match[2] : true
+					if (hold === 0) {
+						console.log(`oopsy error: ${arg} should have a hold time of at least 1ms`)
+						process.exit(-1)
+					}
+					if (cpps.length) cpp_idles[cpps[cpps.length-1]] = hold
+					else options.idle = hold
+					break;
+				}
+				// repeats of each render until it has been timed for this long, e.g. repeat200ms:
+				match = arg.match(/^repeat(\d+)ms$/)
+				if (match) {
+					options.repeat_ms = +match[1]
+					break;
+				}
+				// polyphony, e.g. poly8, for the cpp named before it or every app:
+				match = arg.match(/^poly(\d+)$/)
+				if (match) {
+					const voices = +match[1]
+					if (voices < 2 || voices > 16) {
+						console.log(`oopsy error: ${arg} should have from 2 to 16 voices`)
+						process.exit(-1)
+					}
+					if (cpps.length) cpp_voices[cpps[cpps.length-1]] = voices
+					else options.voices = voices
+					break;
+				}
+				// per-function fastmath tiers, e.g. fastmath=tanh,exp:fast
+				match = arg.match(/^fastmath=(.+)$/)
+				if (match) {
+					options.fastmath_tiers = options.fastmath_tiers || {}
+					match[1].split(",").forEach(item => {
+						let [name, tier="faster"] = item.split(":")
+						let names = (name == "all") ? fastmath_functions : [name]
+						if (!fastmath_functions.includes(names[0]) || !fastmath_tiers.includes(tier)) {
+							console.log(`oopsy error: ${item} is not a recognized fastmath function (${fastmath_functions.join(", ")} or all) and tier (${fastmath_tiers.join(", ")})`)
+							process.exit(-1)
+						}
+						names.forEach(name => options.fastmath_tiers[name] = tier)
+					})
+					break;
+				}
 				// assume anything else is a file path:
 				if (!fs.existsSync(arg)) {
 					console.log(`oopsy error: ${arg} is not a recognized argument or a path that does not exist`)
@@ -513,6 +742,8 @@ function run() {
 					switch(p.ext) {
 						case ".json": {target_path = arg; target = ""}; break;
 						case ".cpp": cpps.push(arg); break;
+						case ".wav": options.render_input = arg; break;
+						case ".txt": options.render_script = arg; break;
 						// case ".gendsp":
 						// case ".maxpat":
 						// case ".maxhelp": {pat_path = arg}; break;
@@ -525,14 +756,26 @@ function run() {
 		}
 	});
 
+	// rendering on the host doesn't need the ARM toolchain:
+	if (action == "render") {
+		// the binary is built for the largest block size, and can run any smaller:
+		if (blocksizes.length) blocksize = Math.max(...blocksizes)
+		if (samplerates.length) samplerate = Math.max(...samplerates)
+	} else {
+		checkBuildEnvironment();
+	}
+
 	// remove duplicates:
 	cpps = cpps.reduce(function (acc, s) {
 		if (acc.indexOf(s) === -1) acc.push(s)
 		return acc
 	}, []);
-	cpps.sort((a,b)=>{
-		return path.basename(a) < path.basename(b) ? -1 : 0;
-	})
+	// chained apps run in the order given:
+	if (!options.chain) {
+		cpps.sort((a,b)=>{
+			return path.basename(a) < path.basename(b) ? -1 : 0;
+		})
+	}
 
 	let OOPSY_TARGET_SEED = 0
 
@@ -566,7 +809,7 @@ function run() {
 		hardware.struct = "";
 
 		if (hardware.components) {
-			hardware.struct = generate_target_struct(hardware);
+			configure_target_components(hardware);
 			// generate IO
 			for (let component of hardware.components) {
 
@@ -581,6 +824,7 @@ function run() {
 						if (mapping.get) {
 							// an input
 							hardware.inputs[name] = {
+								component: component.name,
 								code: template(mapping.get, component),
 								automap: component.automap && name == component.name,
 								range: mapping.range,
@@ -591,6 +835,7 @@ function run() {
 						if (mapping.set) {
 							// an output
 							hardware.outputs[name] = {
+								component: component.name,
 								code: template(mapping.set, component),
 								automap: component.automap && name == component.name,
 								range: mapping.range,
@@ -627,7 +872,8 @@ function run() {
 
 	// verify and analyze cpps:
 	assert(cpps.length > 0, "an argument specifying the path to at least one gen~ exported cpp file is required");
-	if (hardware.max_apps && cpps.length > hardware.max_apps) {
+	// (a chain of apps counts as a single app)
+	if (hardware.max_apps && cpps.length > hardware.max_apps && !options.chain) {
 		console.log(`this target does not support more than ${hardware.max_apps} apps`)
 		cpps.length = hardware.max_apps
 	}
@@ -635,9 +881,21 @@ function run() {
 		assert(fs.existsSync(cpp_path), `couldn't find source C++ file ${cpp_path}`);
 		return {
 			path: cpp_path,
-			patch: analyze_cpp(fs.readFileSync(cpp_path, "utf8"), hardware, cpp_path)
+			patch: analyze_cpp(fs.readFileSync(cpp_path, "utf8"), hardware, cpp_path),
+			chained: !!options.chain,
+			rate: cpp_rates[cpp_path] || options.rate || 1,
+			voices: cpp_voices[cpp_path] || options.voices || 1,
+			idle: cpp_idles[cpp_path] !== undefined ? cpp_idles[cpp_path] : (options.idle || false),
 		}
 	})
+	if (options.chain) {
+		// params of chained apps share one param view, so offset their indices:
+		let param_offset = 0
+		apps.forEach(app => {
+			app.param_offset = param_offset
+			param_offset += app.patch.params.length
+		})
+	}
 	let build_name = apps.map(v=>v.patch.name).join("_")
 
 	// configure build path:
@@ -660,7 +918,7 @@ function run() {
 		defines.OOPSY_TARGET_USES_MIDI_UART = 1
 	}
 
-	if (apps.length > 1) {
+	if (apps.length > 1 && !options.chain) {
 		defines.OOPSY_MULTI_APP = 1
 		// generate midi-handling code for any multi-app on a midi-enabled platform
 		// so that program-change messages for apps will work:
@@ -681,11 +939,51 @@ function run() {
 	if (options.fastmath) {
 		hardware.defines.GENLIB_USE_FASTMATH = 1;
 	}
+	if (options.ftz) {
+		hardware.defines.GENLIB_FLUSH_DENORMALS = 1;
+	}
+	if (options.fixedphasor) {
+		hardware.defines.GENLIB_FIXED_PHASOR = 1;
+	}
+	if (options.planar) {
+		hardware.defines.GENLIB_DATA_PLANAR = 1;
+	}
+	if (options.profile) {
+		hardware.defines.OOPSY_PROFILE = 1;
+	}
+	if (options.tcm) {
+		hardware.defines.OOPSY_TCM = 1;
+	}
+	Object.keys(options.fastmath_tiers || {}).forEach(name => {
+		hardware.defines[`GENLIB_FASTMATH_${name.toUpperCase()}`] = `GENLIB_FASTMATH_${options.fastmath_tiers[name].toUpperCase()}`
+	})
+	if (options.sinetable) {
+		hardware.defines.GENLIB_SINETABLE_BITS = options.sinetable;
+	}
+	if (defines.OOPSY_USE_PRESETS) {
+		// every snapshot is stored with the same size, big enough for any app:
+		const sizes = apps.map(app => preset_size(app.patch))
+		defines.OOPSY_PRESET_SIZE = options.chain ? sizes.reduce((a, b) => a + b, 0) : Math.max(...sizes)
+		// each flash bank must be able to hold the latest snapshot of every slot of every app:
+		const snapshots = (options.chain ? 1 : apps.length) * PRESET_SLOTS
+		// (otherwise compaction could not free a record, and every save would erase a bank & still fail)
+		if (snapshots > Math.floor(PRESET_BANK_SIZE / (PRESET_RECORD_HEADER + defines.OOPSY_PRESET_SIZE))) {
+			console.log(`oopsy error: presets of ${defines.OOPSY_PRESET_SIZE} bytes are too large to store all ${PRESET_SLOTS} slots of ${snapshots / PRESET_SLOTS} app(s)`)
+			process.exit(-1)
+		}
+	}
 
 	const makefile_path = path.join(build_path, `Makefile`)
-	const bin_path = path.join(build_path, "build", build_name+".bin");
+	const bin_path = path.join(build_path, "build", build_name+(defines.OOPSY_TARGET_HOST ? "" : ".bin"));
 	const maincpp_path = path.join(build_path, `${build_name}_${target}.cpp`);
-	fs.writeFileSync(makefile_path, `
+	fs.writeFileSync(makefile_path, defines.OOPSY_TARGET_HOST ? `
+# Project Name
+TARGET = ${build_name}
+# a native build for rendering on this computer (with make's default $(CXX)), with the same float32 genlib as the Daisy:
+build/$(TARGET): ${posixify_path(path.relative(build_path, maincpp_path).replace(" ", "\\ "))}
+	mkdir -p build
+	$(CXX) -std=c++14 -O3 -pthread -DNDEBUG -DGENLIB_USE_FLOAT32 -I"${posixify_path(path.relative(build_path, path.join(__dirname, "gen_dsp")))}" -Wno-unused-but-set-variable -Wno-unused-parameter -Wno-unused-variable -o $@ $<
+` : `
 # Project Name
 TARGET = ${build_name}
 # Sources -- note, won't work with paths with spaces
@@ -703,8 +1001,13 @@ CFLAGS+=-I"${posixify_path(path.relative(build_path, path.join(__dirname, "gen_d
 # Silence irritating warnings:
 CFLAGS+=-O3 -Wno-unused-but-set-variable -Wno-unused-parameter -Wno-unused-variable
 CPPFLAGS+=-O3 -Wno-unused-but-set-variable -Wno-unused-parameter -Wno-unused-variable
-
+${defines.OOPSY_TCM ? `# Place the OOPSY_ITCM & OOPSY_DTCM sections
+# (the fragment must come before libdaisy's linker script, to INSERT into it):
+LDFLAGS:=-T oopsy_tcm.ld $(LDFLAGS)` : ``}
 `, "utf-8");
+	if (defines.OOPSY_TCM && !defines.OOPSY_TARGET_HOST) {
+		fs.writeFileSync(path.join(build_path, "oopsy_tcm.ld"), tcm_linker_script, "utf-8");
+	}
 
 	console.log(`Will ${action} from ${cpps.join(", ")} by writing to:`)
 	console.log(`\t${maincpp_path}`)
@@ -722,6 +1025,17 @@ CPPFLAGS+=-O3 -Wno-unused-but-set-variable -Wno-unused-parameter -Wno-unused-var
 		generate_app(app, hardware, target, config);
 		return app;
 	})
+	if (hardware.components) {
+		hardware.struct = generate_target_struct(hardware, used_components(hardware, apps));
+	}
+	// chained apps are wrapped up as a single app:
+	const appunits = options.chain ? [generate_chain(apps, hardware, options.chain)] : apps;
+	// block buffers are handed out from a shared arena, sized for the app that needs the most:
+	const scratch_counts = apps.map(app => app.audio_outs.length + (app.has_discard_out ? 1 : 0) + app.cv_streams.length + app.voice_scratch)
+	const scratch_count = options.chain 
+		? scratch_counts.reduce((a, b) => a + b, 0) + (options.chain == "parallel" ? hardware.defines.OOPSY_IO_COUNT : 0)
+		: Math.max(...scratch_counts)
+	hardware.defines.OOPSY_SCRATCH_COUNT = `OOPSY_SCRATCH_RESERVED + ${Math.max(1, scratch_count)}`
 
 	// store for debugging:
 	//if (options.writejson) fs.writeFileSync(path.join(build_path, `${build_name}_${target}.json`), JSON.stringify(config,null,"  "),"utf8");
@@ -747,19 +1061,29 @@ ${Object.keys(hardware.defines).map(k=>`
 ${hardware.struct}
 
 ${hardware.inserts.filter(o => o.where == "header").map(o => o.code).join("\n")}
-#include "../genlib_daisy.h"
+#include "../${defines.OOPSY_TARGET_HOST ? "genlib_host.h" : "genlib_daisy.h"}"
 #include "../genlib_daisy.cpp"
 
 ${apps.map(app => `#include "${posixify_path(path.relative(build_path, app.path))}"`).join("\n")}
 ${apps.map(app => app.cpp.struct).join("\n")}
+${options.chain ? appunits[0].cpp.struct : ""}
+${defines.OOPSY_TARGET_HOST ? `
+// every app is rendered separately:
+oopsy::AppDef appdefs[] = {
+	${appunits.map(app => app.cpp.hostdef).join("\n\t")}
+};
 
+int main(int argc, char ** argv) {
+	return oopsy::host_main(argc, argv, appdefs, ${appunits.length});
+}
+` : `
 // store apps in a union to re-use memory, since only one app is active at once:
 union {
-	${apps.map(app => app.cpp.union).join("\n\t")}
+	${appunits.map(app => app.cpp.union).join("\n\t")}
 } apps;
 
 oopsy::AppDef appdefs[] = {
-	${apps.map(app => app.cpp.appdef).join("\n\t")}
+	${appunits.map(app => app.cpp.appdef).join("\n\t")}
 };
 
 int main(void) {
@@ -772,13 +1096,18 @@ int main(void) {
 	oopsy::daisy.hardware.SetAudioBlockSize(${hardware.defines.OOPSY_BLOCK_SIZE});
 	${hardware.inserts.filter(o => o.where == "init").map(o => o.code).join("\n\t")}
 	// insert custom hardware initialization here
-	return oopsy::daisy.run(appdefs, ${apps.length});
+	OOPSY_PROFILE_MARK("hardware init");
+	return oopsy::daisy.run(appdefs, ${appunits.length});
 }
-`
+`}`
 	fs.writeFileSync(maincpp_path, cppcode, "utf-8");	
 
 	console.log("oopsy generated code")
 
+	if (action == "render") {
+		return render(build_path, build_name, path.dirname(apps[0].path), appunits.length, samplerates.length ? samplerates : [samplerate], blocksizes.length ? blocksizes : [blocksize], options)
+	}
+
 	// now try to make:
 	try {
 		console.log("oopsy compiling...")
@@ -794,6 +1123,7 @@ int main(void) {
 					execSync(line, { cwd: build_path }).toString()
 			})
 			console.log(`oopsy created binary ${Math.ceil(fs.statSync(posixify_path(path.join(build_path, "build", build_name+".bin")))["size"]/1024)}KB`)
+			if (defines.OOPSY_TCM) tcm_report(build_path, build_name)
 			// if successful, try to upload to hardware:
 			if (has_dfu_util && action=="upload") {
 				console.log("oopsy flashing...")
@@ -825,9 +1155,13 @@ int main(void) {
 					console.log("oopsy compiler error")
 					console.log(err);
 					console.log(stderr);
+					if (/region .?(ITCMRAM|DTCMRAM).? overflowed/.test(stderr)) {
+						console.log("oopsy the audio path or static data does not fit in TCM; try building without tcm")
+					}
 					return;
 				}
 				console.log(`oopsy created binary ${Math.ceil(fs.statSync(posixify_path(path.join(build_path, "build", build_name+".bin")))["size"]/1024)}KB`)
+				if (defines.OOPSY_TCM) tcm_report(build_path, build_name)
 				// if successful, try to upload to hardware:
 				if (has_dfu_util && action=="upload") {
 					console.log("oopsy flashing...")
@@ -860,6 +1194,66 @@ int main(void) {
 	}
 }
 
+// reports what the tcm option placed in ITCM and DTCM, from the linker map,
+// with the full list of symbols written to build/<name>_tcm.txt:
+function tcm_report(build_path, build_name) {
+	const map_path = path.join(build_path, "build", `${build_name}.map`)
+	if (!fs.existsSync(map_path)) return;
+	const lines = fs.readFileSync(map_path, "utf8").split(/\r?\n/)
+	let report = []
+	;[["ITCM", ".oopsy_itcm", 64], ["DTCM", ".oopsy_dtcm", 128]].forEach(([region, section, kb]) => {
+		const start = lines.findIndex(line => line.startsWith(section))
+		if (start < 0) return;
+		const [, base, size] = lines[start].match(/0x([0-9a-f]+)\s+0x([0-9a-f]+)/)
+		const end = parseInt(base, 16) + parseInt(size, 16)
+		// symbols are listed by address, up to the next output section:
+		let symbols = []
+		for (let i=start+1; i<lines.length && !/^\S/.test(lines[i]); i++) {
+			const m = lines[i].match(/^\s+0x([0-9a-f]+)\s+([^=]+)$/)
+			if (m) symbols.push({ address: parseInt(m[1], 16), name: m[2].trim() })
+		}
+		symbols.forEach((sym, i) => sym.size = (i+1 < symbols.length ? symbols[i+1].address : end) - sym.address)
+		symbols.sort((a, b) => b.size - a.size)
+		console.log(`oopsy ${region} ${(parseInt(size, 16)/1024).toFixed(1)}KB of ${kb}KB`)
+		symbols.slice(0, 4).forEach(sym => console.log(`\t${sym.size} bytes ${sym.name.slice(0, 72)}`))
+		report.push(`${region} (${section}) ${parseInt(size, 16)} of ${kb*1024} bytes`, ...symbols.map(sym => `\t${sym.size}\t${sym.name}`), "")
+	})
+	fs.writeFileSync(path.join(build_path, "build", `${build_name}_tcm.txt`), report.join("\n"), "utf-8")
+}
+
+// compiles the host build with the native toolchain, then renders every app at every samplerate & blocksize
+// the binary runs these jobs on a thread pool, and writes a WAV per job plus a render.json summary
+function render(build_path, build_name, data_path, app_count, samplerates, blocksizes, options) {
+	const render_path = path.join(build_path, "render")
+	fs.mkdirSync(render_path, {recursive: true});
+	try {
+		console.log("oopsy compiling for host...")
+		execSync("make", { cwd: build_path, stdio: "inherit" })
+	} catch (e) {
+		console.log("oopsy compiler error")
+		return;
+	}
+	let args = [
+		"-o", render_path,
+		"-d", path.resolve(data_path),
+		"-r", samplerates.map(khz => khz*1000).join(","),
+		"-b", blocksizes.join(","),
+	]
+	if (options.render_input) args.push("-i", path.resolve(options.render_input))
+	if (options.render_script) args.push("-s", path.resolve(options.render_script))
+	if (options.repeats) args.push("-n", `${options.repeats}`)
+	if (options.repeat_ms) args.push("-t", `${options.repeat_ms}`)
+	console.log(`oopsy rendering ${app_count * samplerates.length * blocksizes.length} jobs to ${render_path}`)
+	try {
+		execFileSync(path.join(build_path, "build", build_name), args, { stdio: "inherit" })
+	} catch (e) {
+		console.log("oopsy render failed")
+		return;
+	}
+	return JSON.parse(fs.readFileSync(path.join(render_path, "render.json"), "utf8"))
+		.map(job => Object.assign(job, { path: path.join(render_path, job.file) }))
+}
+
 function analyze_cpp(cpp, hardware, cpp_path) {
 
 	// helper function to parse initializers:
@@ -916,6 +1310,13 @@ function analyze_cpp(cpp, hardware, cpp_path) {
 				result.midi_type = midimatch[1];
 			} 
 
+			// if this controls presets, e.g. [history preset_recall_out]:
+			let presetmatch
+			if (presetmatch = /^preset_(recall|save|morph)$/g.exec(name)) {
+				result.preset_type = presetmatch[1];
+				hardware.defines.OOPSY_USE_PRESETS = 1;
+			}
+
 			// find the initializer:
 			result.default = constexpr( new RegExp(`\\s${cname}\\s+=\\s+([^;]+);`, "gm").exec(cpp)[1] );
 
@@ -1094,6 +1495,8 @@ function generate_app(app, hardware, target, config) {
 	app.audio_outs = []
 	app.midi_outs = []
 	app.midi_noteouts = []
+	app.preset_outs = []
+	app.cv_streams = []
 	app.has_midi_in = false
 	app.has_generic_midi_in = false
 	app.has_midi_out = false
@@ -1104,6 +1507,14 @@ function generate_app(app, hardware, target, config) {
 	app.nodes = nodes;
 	app.inserts = [];
 
+	// poly<N> apps run N instances of gen~, one per MIDI note (see oopsy::Voices):
+	let voices = app.voices
+	if (voices > 1 && !defines.OOPSY_TARGET_HAS_MIDI_INPUT) {
+		console.warn(`oopsy warning: ${name} can't be polyphonic without MIDI input on this target`)
+		voices = 1
+	}
+	if (voices > 1) app.has_midi_in = true;
+
 	gen.audio_ins = app.patch.ins.map((s, i)=>{
 		let name = "gen_in"+(i+1)
 		let label = s.replace(/"/g, "").trim();
@@ -1116,6 +1527,12 @@ function generate_app(app, hardware, target, config) {
 				app.has_generic_midi_in = true;
 				if (label == "midithru") app.has_generic_midi_thru = true;
 			}
+		} else if (daisy.device_inputs.indexOf(hardware.labels.params[label]) >= 0) {
+			// a knob/CV etc. delivered as an audio-rate signal, e.g. [in 3 cv1]:
+			let input = hardware.labels.params[label]
+			if (app.cv_streams.indexOf(input) < 0) app.cv_streams.push(input)
+			nodes[input].to.push(name)
+			src = `cv_${input}`
 		} else if (daisy.audio_ins.length > 0) {
 			src = daisy.audio_ins[i % daisy.audio_ins.length];
 		}
@@ -1125,7 +1542,7 @@ function generate_app(app, hardware, target, config) {
 			// index: i,
 			src: src,
 		}
-		if (src) {
+		if (src && nodes[src]) {
 			nodes[src].to.push(name)
 		}
 		return name;
@@ -1177,6 +1594,8 @@ function generate_app(app, hardware, target, config) {
 			nodes[src].src = src;
 		}
 		nodes[name].label = label
+		// (as a control signal, it would be held rather than filtered when resampled)
+		node.mapped = !!map
 		// was this out mapped to something?
 		if (map) {
 			nodes[map].from.push(src);
@@ -1185,6 +1604,14 @@ function generate_app(app, hardware, target, config) {
 		return name;
 	})
 
+	// gen~ outs beyond the hardware outs that don't feed anything can all share one buffer:
+	app.audio_outs = app.audio_outs.filter(src => {
+		if (nodes[src].to.length) return true;
+		gen.audio_outs.map(name => nodes[name]).filter(node => node.src == src).forEach(node => node.src = "discard_out")
+		app.has_discard_out = true
+		return false
+	})
+
 	gen.histories = app.patch.histories.map(history=>{
 		const name = history.name
 		const varname = "gen_history_"+name;
@@ -1284,6 +1711,10 @@ function generate_app(app, hardware, target, config) {
 					nodes[name] = node		
 				} 
 			}
+		} else if (node.preset_type) {
+			app.preset_outs.push(node)
+			node.type = "float";
+			nodes[name] = node
 		} else {
 
 			// search for a matching [out] name / prefix:
@@ -1328,6 +1759,13 @@ function generate_app(app, hardware, target, config) {
 		// e.g.
 		// [param midi_cc100_ch1] // input is 0..1 for cc value
 		// [param midi_cc74]	  // default channel 1
+		if (voices > 1 && (match = (/^voice_(pitch|vel|gate)$/g).exec(param.name))) {
+			// set for each voice from its note, see the poly audioCallback:
+			node.where = "voice"
+			src = node.where
+			node.voice = match[1] == "pitch" ? `voices.voice[v].pitch` 
+				: `voices.voice[v].${match[1]}*${asCppNumber(node.range)} + ${asCppNumber(node.min)}`
+		} else
 		if (match = (/^midi_cc(\d+)(_(ch)?(\d+))?/g).exec(param.name)) {
 			let ch = match[4] ? ((+match[4])+15)%16 : null;
 			let cc = (+match[1])%128;
@@ -1527,6 +1965,58 @@ function generate_app(app, hardware, target, config) {
 		});
 	}
 
+	// hardware outs that nothing writes to only need clearing once,
+	// unless other apps in a chain share the hardware buffers:
+	const cleared_outs = app.chained ? [] : daisy.audio_outs.filter(name => !nodes[name].src 
+		&& !gen.audio_outs.some(out => nodes[out].src == name))
+
+	// run gen~ at a multiple of the hardware rate? (see RateIn & RateOut in genlib_ops.h)
+	let rate = app.rate
+	if (rate != 1) {
+		if (voices > 1) {
+			console.warn(`oopsy warning: ${name} is polyphonic, so it can't be oversampled or undersampled`)
+			rate = 1
+		} else if (app.has_generic_midi_in || daisy.midi_outs.some(name => nodes[name].from.length)) {
+			console.warn(`oopsy warning: ${name} streams MIDI through its ins or outs, so it can't be oversampled or undersampled`)
+			rate = 1
+		} else if (rate < 1 && defines.OOPSY_BLOCK_SIZE % 2) {
+			console.warn(`oopsy warning: ${name} can only be undersampled with an even block size`)
+			rate = 1
+		}
+	}
+	// the FACTOR of RateIn & RateOut, and expressions for the rate & block size of gen~:
+	const rate_factor = rate < 1 ? -Math.round(1/rate) : rate
+	const rate_scale = rate < 1 ? `/${Math.round(1/rate)}` : `*${rate}`
+	// audio is filtered, control signals (cv streams in, mapped outs) are held or picked:
+	const rate_ins = gen.audio_ins.filter(name => nodes[name].src)
+	const rate_outs = gen.audio_outs.filter(name => nodes[name].src != "discard_out")
+	const rate_filtered = name => nodes[name].mapped === undefined ? daisy.audio_ins.includes(nodes[name].src) : !nodes[name].mapped
+
+	// each voice performs into its own outs, which are summed (audio) or taken from the newest voice (mapped outs):
+	const voice_params = gen.params.filter(name => nodes[name].voice)
+	const voice_outs = gen.audio_outs.filter(name => nodes[name].src != "discard_out")
+	app.voice_scratch = voices > 1 ? gen.audio_outs.length + voice_outs.length : 0
+	if (voices > 1 && !voice_params.length) {
+		console.warn(`oopsy warning: ${name} has no voice_pitch, voice_vel or voice_gate params, so its ${voices} voices will all sound the same`)
+	}
+	// skip perform while the app is silent? it wakes on its audio ins:
+	let idle = app.idle
+	const idle_ins = [...new Set(gen.audio_ins.map(name => nodes[name].src).filter(src => daisy.audio_ins.includes(src)))]
+	const idle_outs = gen.audio_outs.map(name => nodes[name].src).filter(src => src != "discard_out")
+	if (idle && voices > 1) {
+		console.warn(`oopsy warning: ${name} is polyphonic, which already skips silent voices, so idle is ignored`)
+		idle = false
+	} else if (idle && !idle_ins.length) {
+		console.warn(`oopsy warning: ${name} has no audio ins to wake it, so idle is ignored`)
+		idle = false
+	}
+	const idle_hold = idle === true ? "OOPSY_IDLE_HOLD_MS" : idle
+	// MIDI notes for the voices:
+	const voice_note_code = voices > 1 ? `if (daisy.midi.lastbyte == 1 && (daisy.midi.status/16 == 8 || daisy.midi.status/16 == 9)) {
+					voices.note(daisy.midi.byte[0] & 0x7F, daisy.midi.status/16 == 9 ? daisy.midi.byte[1] & 0x7F : 0);
+				}
+				` : ""
+
 	const struct = `
 
 struct App_${name} : public oopsy::App<App_${name}> {
@@ -1535,7 +2025,7 @@ struct App_${name} : public oopsy::App<App_${name}> {
 	${nodes[name].type} ${name};`).join("")}
 	${app.midi_noteouts.map(note=>`
 	oopsy::GenDaisy::MidiNote ${note.cname};`).join("")}
-	${gen.histories.map(name=>nodes[name]).filter(node => node && node.midi_type).map(node=>`
+	${gen.histories.map(name=>nodes[name]).filter(node => node && (node.midi_type || node.preset_type)).map(node=>`
 	${node.type} ${node.varname};`).join("")}
 	${gen.audio_outs.map(name=>nodes[name]).filter(node => node && node.midi_type).map(node=>`
 	${node.type} ${node.varname};`).join("")}
@@ -1544,17 +2034,69 @@ struct App_${name} : public oopsy::App<App_${name}> {
 		.map(node=>`
 	float ${node.name};`).join("")}
 	${app.audio_outs.map(name=>`
-	float ${name}[OOPSY_BLOCK_SIZE];`).join("")}
+	float * ${name};`).join("")}
+	${app.has_discard_out ? `float * discard_out; // written by gen~ but never read` : ""}
+	${cleared_outs.map(name=>`
+	float * cleared_${name};`).join("")}
+	${app.cv_streams.map(name=>`
+	oopsy::CvStream cv_stream_${name};`).join("")}
+	${rate != 1 ? `// gen~ runs at ${rate}x the hardware rate, on these buffers:
+	${gen.audio_ins.map(name=>`
+	float * rate_${name};`).join("")}
+	${gen.audio_outs.map(name=>`
+	float * rate_${name};`).join("")}
+	${rate_ins.filter(rate_filtered).map(name=>`
+	RateIn<${rate_factor}> rate_filter_${name};`).join("")}
+	${rate_outs.filter(rate_filtered).map(name=>`
+	RateOut<${rate_factor}> rate_filter_${name};`).join("")}
+	${rate_factor == 4 ? `float * rate_tmp;` : ""}` : ""}
+	${idle ? `oopsy::Idle idle;` : ""}
+	${voices > 1 ? `oopsy::Voices<${voices}> voices;
+	void * voice_gen[${voices}];
+	${gen.audio_outs.map(name=>`
+	float * voice_${name};`).join("")}
+	${voice_outs.map(name=>`
+	float * voice_sum_${name};`).join("")}` : ""}
 	
 	void init(oopsy::GenDaisy& daisy) {
 		#ifdef OOPSY_TARGET_PATCH_SM
-		daisy.gen = ${name}::create(daisy.hardware.AudioSampleRate(), daisy.hardware.AudioBlockSize());
+		daisy.gen = ${name}::create(daisy.hardware.AudioSampleRate()${rate != 1 ? rate_scale : ""}, daisy.hardware.AudioBlockSize()${rate != 1 ? rate_scale : ""});
 		#else
-		daisy.gen = ${name}::create(daisy.hardware.seed.AudioSampleRate(), daisy.hardware.seed.AudioBlockSize());
+		daisy.gen = ${name}::create(daisy.hardware.seed.AudioSampleRate()${rate != 1 ? rate_scale : ""}, daisy.hardware.seed.AudioBlockSize()${rate != 1 ? rate_scale : ""});
 		#endif
+		${voices > 1 ? `// the first voice is daisy.gen, which the menu, presets, data and MIDI outs use:
+		voice_gen[0] = daisy.gen;
+		for (int v=1; v<${voices}; v++) {
+			#ifdef OOPSY_TARGET_PATCH_SM
+			voice_gen[v] = ${name}::create(daisy.hardware.AudioSampleRate(), daisy.hardware.AudioBlockSize());
+			#else
+			voice_gen[v] = ${name}::create(daisy.hardware.seed.AudioSampleRate(), daisy.hardware.seed.AudioBlockSize());
+			#endif
+		}
+		voices.init();` : ""}
+		OOPSY_PROFILE_MARK("create");
+		${idle ? `#ifdef OOPSY_TARGET_PATCH_SM
+		idle.init(${idle_hold} * daisy.hardware.AudioSampleRate() / 1000);
+		#else
+		idle.init(${idle_hold} * daisy.hardware.seed.AudioSampleRate() / 1000);
+		#endif` : ""}
+		${rate != 1 ? `${gen.audio_ins.concat(gen.audio_outs).map(name=>`
+		rate_${name} = (float *)genlib_sysmem_newptrclear(sizeof(float) * (OOPSY_BLOCK_SIZE${rate_scale}));`).join("")}
+		${rate_ins.concat(rate_outs).filter(rate_filtered).map(name=>`
+		rate_filter_${name}.reset();`).join("")}
+		${rate_factor == 4 ? `rate_tmp = (float *)genlib_sysmem_newptrclear(sizeof(float) * 2 * OOPSY_BLOCK_SIZE);` : ""}` : ""}
 		${name}::State& gen = *(${name}::State *)daisy.gen;
 		
 		daisy.param_count = ${gen.params.length};
+		${app.audio_outs.concat(app.has_discard_out ? ["discard_out"] : []).map(name=>`
+		${name} = oopsy::scratch_buffer();`).join("")}
+		${app.cv_streams.map(name=>`
+		cv_stream_${name}.init();`).join("")}
+		${voices > 1 ? gen.audio_outs.map(name=>`
+		voice_${name} = oopsy::scratch_buffer();`).join("") + voice_outs.map(name=>`
+		voice_sum_${name} = oopsy::scratch_buffer();`).join("") : ""}
+		${cleared_outs.map(name=>`
+		cleared_${name} = nullptr;`).join("")}
 		${(defines.OOPSY_HAS_PARAM_VIEW) ? `daisy.param_selected = ${Math.max(0, gen.params.map(name=>nodes[name].src).indexOf(undefined))};`:``}
 		${gen.params.map(name=>nodes[name])
 			.map(node=>`
@@ -1563,7 +2105,7 @@ struct App_${name} : public oopsy::App<App_${name}> {
 			.filter(node => node.src || node.from.length)
 			.map(node=>`
 		${node.name} = 0.f;`).join("")}
-		${gen.histories.map(name=>nodes[name]).filter(node => node && node.midi_type).map(node=>`
+		${gen.histories.map(name=>nodes[name]).filter(node => node && (node.midi_type || node.preset_type)).map(node=>`
 		${node.varname} = ${asCppNumber(node.default, node.type)};`).join("")}
 		${daisy.datahandlers.map(name => nodes[name])
 			.filter(node => node.init)
@@ -1572,14 +2114,15 @@ struct App_${name} : public oopsy::App<App_${name}> {
 		${interpolate(node.init, node)};`).join("")}
 		${gen.datas.map(name=>nodes[name])
 			.filter(node => node.wavname)
-			.map(node=>`
+			.map(node=> voices > 1 ? `
+		for (int v=0; v<${voices}; v++) daisy.sdcard_load_wav("${node.wavname}", ((${name}::State *)voice_gen[v])->${node.cname});` : `
 		daisy.sdcard_load_wav("${node.wavname}", gen.${node.cname});`).join("")}
 	}
 
-	void audioCallback(oopsy::GenDaisy& daisy, daisy::AudioHandle::InputBuffer hardware_ins, daisy::AudioHandle::OutputBuffer hardware_outs, size_t size) {
+	OOPSY_ITCM_FLATTEN void audioCallback(oopsy::GenDaisy& daisy, daisy::AudioHandle::InputBuffer hardware_ins, daisy::AudioHandle::OutputBuffer hardware_outs, size_t size) {
 		Daisy& hardware = daisy.hardware;
 		${name}::State& gen = *(${name}::State *)daisy.gen;
-		${app.inserts.concat(hardware.inserts).filter(o => o.where == "audio").map(o => o.code).join("\n\t")}
+		${app.inserts.concat(app.chained ? [] : hardware.inserts).filter(o => o.where == "audio").map(o => o.code).join("\n\t")}
 		${daisy.device_inputs.map(name => nodes[name])
 			.filter(node => node.to.length)
 			.filter(node => node.update && node.update.where == "audio")
@@ -1595,7 +2138,7 @@ struct App_${name} : public oopsy::App<App_${name}> {
 			.filter(node => node.where == "audio" || node.where == undefined)
 			.map(node=>`
 		${node.varname} = (${node.type})(${node.src}*${asCppNumber(node.range)} + ${asCppNumber(node.min + (node.type == "int" || node.type == "bool" ? 0.5 : 0))});`).join("")}
-		${gen.params
+		${voices > 1 ? "" : gen.params
 			.map(name=>nodes[name])
 			.map(node=>`
 		gen.set_${node.name}(${node.varname});`).join("")}
@@ -1605,11 +2148,63 @@ struct App_${name} : public oopsy::App<App_${name}> {
 		float * ${name} = hardware_outs[${i}];`).join("")}
 		${app.has_midi_in ? daisy.midi_ins.map(name=>`
 		float * ${name} = daisy.midi_in_data;`).join("") : ''}
+		${app.cv_streams.map(name=>`
+		float * cv_${name} = cv_stream_${name}.process(${name}, size);`).join("")}
+		${idle ? `
+		float * idle_ins[] = { ${idle_ins.join(", ")} };
+		if (idle.wake(idle_ins, ${idle_ins.length}, size)) {` : ""}
+		${voices > 1 ? `
+		// ${gen.audio_ins.map(name=>nodes[name].label).join(", ")}:
+		float * inputs[] = { ${gen.audio_ins.map(name=>nodes[name].src).join(", ")} }; 
+		// ${gen.audio_outs.map(name=>nodes[name].label).join(", ")}:
+		float * outputs[] = { ${gen.audio_outs.map(name=>`voice_${name}`).join(", ")} };
+		voices.update();
+		${voice_outs.map(name=>`
+		memset(voice_sum_${name}, 0, sizeof(float)*size);`).join("")}
+		for (int v=0; v<${voices}; v++) {
+			if (!voices.voice[v].active) continue; // released and silent
+			${name}::State& voice = *(${name}::State *)voice_gen[v];
+			${gen.params
+				.map(name=>nodes[name])
+				.map(node=>`
+			voice.set_${node.name}(${node.voice ? `(${node.type})(${node.voice})` : node.varname});`).join("")}
+			voice.perform(inputs, outputs, size);
+			float peak = 0.f;
+			${voice_outs.filter(name => !nodes[name].mapped).length ? `for (size_t i=0; i<size; i++) {
+				${voice_outs.filter(name => !nodes[name].mapped).map(name=>`
+				voice_sum_${name}[i] += voice_${name}[i];
+				peak = fmaxf(peak, fabsf(voice_${name}[i]));`).join("")}
+			}` : ""}
+			${voice_outs.filter(name => nodes[name].mapped).length ? `if (v == voices.newest) {
+				${voice_outs.filter(name => nodes[name].mapped).map(name=>`
+				memcpy(voice_sum_${name}, voice_${name}, sizeof(float)*size);`).join("")}
+			}` : ""}
+			voices.settle(v, peak);
+		}
+		${voice_outs.map(name=>`
+		memcpy(${nodes[name].src}, voice_sum_${name}, sizeof(float)*size);`).join("")}` : rate != 1 ? `${rate_ins.map(name => rate_filtered(name) ? `
+		rate_filter_${name}.process(${nodes[name].src}, rate_${name}, size, ${rate_factor == 4 ? "rate_tmp" : "nullptr"});` : `
+		genlib_rate_hold_in<${rate_factor}>(${nodes[name].src}, rate_${name}, size);`).join("")}
+		// ${gen.audio_ins.map(name=>nodes[name].label).join(", ")}:
+		float * inputs[] = { ${gen.audio_ins.map(name=>`rate_${name}`).join(", ")} }; 
+		// ${gen.audio_outs.map(name=>nodes[name].label).join(", ")}:
+		float * outputs[] = { ${gen.audio_outs.map(name=>`rate_${name}`).join(", ")} };
+		gen.perform(inputs, outputs, size${rate_scale});
+		${rate_outs.map(name => rate_filtered(name) ? `
+		rate_filter_${name}.process(rate_${name}, ${nodes[name].src}, size, ${rate_factor == 4 ? "rate_tmp" : "nullptr"});` : `
+		genlib_rate_hold_out<${rate_factor}>(rate_${name}, ${nodes[name].src}, size);`).join("")}` : `
 		// ${gen.audio_ins.map(name=>nodes[name].label).join(", ")}:
 		float * inputs[] = { ${gen.audio_ins.map(name=>nodes[name].src).join(", ")} }; 
 		// ${gen.audio_outs.map(name=>nodes[name].label).join(", ")}:
 		float * outputs[] = { ${gen.audio_outs.map(name=>nodes[name].src).join(", ")} };
-		gen.perform(inputs, outputs, size);
+		gen.perform(inputs, outputs, size);`}
+		${idle ? `
+		float * idle_bufs[] = { ${idle_ins.concat(idle_outs).join(", ")} };
+		idle.settle(idle_bufs, ${idle_ins.length + idle_outs.length}, size);
+		} else { // idle: silent until audio comes in
+		${idle_outs.map(name=>`
+		memset(${name}, 0, sizeof(float)*size);`).join("")}
+		}` : ""}
 		${daisy.device_outs.map(name => nodes[name])
 			.filter(node => node.src || node.from.length)
 			.map(node => node.src ? `
@@ -1632,6 +2227,11 @@ struct App_${name} : public oopsy::App<App_${name}> {
 			${node.varname} = ${node.setter_src};
 			${node.setter}
 		}`).join("")}		
+		${app.preset_outs.map(node=>`
+		if (${node.varname} != (${node.type})gen.${node.cname}) {
+			${node.varname} = gen.${node.cname};
+			${node.preset_type == "morph" ? `daisy.preset_morph(${node.varname} - 1.f);` : `if (${node.varname} >= 1.f) daisy.preset_${node.preset_type}(int(${node.varname}) - 1);`}
+		}`).join("")}
 		${app.midi_noteouts
 			.filter(note=>note.vel && note.pitch)
 			.map(note=>`
@@ -1661,16 +2261,20 @@ struct App_${name} : public oopsy::App<App_${name}> {
 		${daisy.audio_outs.map(name=>nodes[name])
 			.filter(node => node.src != node.name)
 			.map(node=>node.src ? `
-		memcpy(${node.name}, ${node.src}, sizeof(float)*size);` : `
+		memcpy(${node.name}, ${node.src}, sizeof(float)*size);` : cleared_outs.includes(node.name) ? `
+		if (${node.name} != cleared_${node.name}) { // still silent since it was last cleared
+			memset(${node.name}, 0, sizeof(float)*size);
+			cleared_${node.name} = ${node.name};
+		}` : `
 		memset(${node.name}, 0, sizeof(float)*size);`).join("")}
-		${app.inserts.concat(hardware.inserts).filter(o => o.where == "post_audio").map(o => o.code).join("\n\t")}
-		${hardware.defines.OOPSY_TARGET_SEED ? "hardware.PostProcess();" : ""}
+		${app.inserts.concat(app.chained ? [] : hardware.inserts).filter(o => o.where == "post_audio").map(o => o.code).join("\n\t")}
+		${hardware.defines.OOPSY_TARGET_SEED && !app.chained ? "hardware.PostProcess();" : ""}
 	}	
 
 	void mainloopCallback(oopsy::GenDaisy& daisy, uint32_t t, uint32_t dt) {
 		Daisy& hardware = daisy.hardware;
 		${name}::State& gen = *(${name}::State *)daisy.gen;
-		${app.inserts.concat(hardware.inserts).filter(o => o.where == "main").map(o => o.code).join("\n\t")}
+		${app.inserts.concat(app.chained ? [] : hardware.inserts).filter(o => o.where == "main").map(o => o.code).join("\n\t")}
 		${daisy.datahandlers.map(name => nodes[name])
 			.filter(node => node.where == "main")
 			.filter(node => node.data)
@@ -1681,7 +2285,7 @@ struct App_${name} : public oopsy::App<App_${name}> {
 			.filter(node => node.config.where == "main")
 			.map(node=>`
 		${interpolate(node.config.code, node)}`).join("")}
-		${defines.OOPSY_TARGET_USES_MIDI_UART ? `
+		${defines.OOPSY_TARGET_USES_MIDI_UART && app.chained ? "// midi input handled by the chain" : defines.OOPSY_TARGET_USES_MIDI_UART ? `
 		while(daisy.uart.Readable()) {
 			uint8_t byte = daisy.uart.PopRx();
 			if (byte >= 128) { // status byte
@@ -1701,7 +2305,7 @@ struct App_${name} : public oopsy::App<App_${name}> {
 			} else {
 				daisy.midi.lastbyte = !daisy.midi.lastbyte; 
 				daisy.midi.byte[daisy.midi.lastbyte] = byte;
-				${gen.params
+				${voice_note_code}${gen.params
 					.map(name=>nodes[name])
 					.filter(node => node.where == "midi_msg")
 					.map(node=>node.code)
@@ -1725,7 +2329,7 @@ struct App_${name} : public oopsy::App<App_${name}> {
 	void displayCallback(oopsy::GenDaisy& daisy, uint32_t t, uint32_t dt) {
 		Daisy& hardware = daisy.hardware;
 		${name}::State& gen = *(${name}::State *)daisy.gen;
-		${app.inserts.concat(hardware.inserts).filter(o => o.where == "display").map(o => o.code).join("\n\t")}
+		${app.inserts.concat(app.chained ? [] : hardware.inserts).filter(o => o.where == "display").map(o => o.code).join("\n\t")}
 		${daisy.datahandlers.map(name => nodes[name])
 			.filter(node => node.where == "display")
 			.filter(node => node.data)
@@ -1736,9 +2340,27 @@ struct App_${name} : public oopsy::App<App_${name}> {
 			.filter(node => node.config.where == "display")
 			.map(node=>`
 		${interpolate(node.config.code, node)}`).join("")}
-		${hardware.defines.OOPSY_TARGET_SEED ? "hardware.Display();" : ""}
+		${hardware.defines.OOPSY_TARGET_SEED && !app.chained ? "hardware.Display();" : ""}
+	}
+	${defines.OOPSY_TARGET_USES_MIDI_UART && app.chained ? `
+	// called by the chain for each midi status byte received:
+	void midiStatus(oopsy::GenDaisy& daisy, uint8_t byte) {
+		${gen.params
+			.map(name=>nodes[name])
+			.filter(node => node.where == "midi_status")
+			.map(node=>node.code)
+			.join(" else ")}
 	}
 
+	// called by the chain for each midi data byte received:
+	void midiMessage(oopsy::GenDaisy& daisy) {
+		${voice_note_code}${gen.params
+			.map(name=>nodes[name])
+			.filter(node => node.where == "midi_msg")
+			.map(node=>node.code)
+			.join(" else ")}
+	}` : ""}
+
 	${defines.OOPSY_HAS_PARAM_VIEW ? `
 	float setparam(int idx, float val) {
 		switch(idx) {
@@ -1758,18 +2380,222 @@ struct App_${name} : public oopsy::App<App_${name}> {
 		${defines.OOPSY_OLED_DISPLAY_WIDTH < 128 ? `snprintf(label, len, "${node.label.substring(0,5).padEnd(5," ")}" FLT_FMT3 "", FLT_VAR3(${node.varname}) );` : `snprintf(label, len, "${node.src ? 
 			`${node.src.substring(0,3).padEnd(3," ")} ${node.label.substring(0,11).padEnd(11," ")}" FLT_FMT3 ""` 
 			: 
-			`%s ${node.label.substring(0,11).padEnd(11," ")}" FLT_FMT3 "", (daisy.param_is_tweaking && ${i} == daisy.param_selected) ? "enc" : "   "`
+			`%s ${node.label.substring(0,11).padEnd(11," ")}" FLT_FMT3 "", (daisy.param_is_tweaking && ${i + (app.param_offset || 0)} == daisy.param_selected) ? "enc" : "   "`
 			}, FLT_VAR3(${node.varname}) );`}
 		break;`).join("")}
 		}	
 	}
 	` : ""}
 	` : ""}
+	${defines.OOPSY_USE_PRESETS ? `
+	// preset snapshots hold the gen~ params, followed by the contents of any small [data]:
+	size_t getstate(oopsy::GenDaisy& daisy, char * state) {
+		${name}::State& gen = *(${name}::State *)daisy.gen;
+		size_t size = ${name}::getstatesize((CommonState *)&gen);
+		${name}::getstate((CommonState *)&gen, state);
+		${preset_datas(app.patch).map(data=>`
+		if (gen.${data.cname}.dim * gen.${data.cname}.channels >= ${data.dim * data.chans}) memcpy(state + size, gen.${data.cname}.mData, sizeof(float)*${data.dim * data.chans});
+		else memset(state + size, 0, sizeof(float)*${data.dim * data.chans});
+		size += sizeof(float)*${data.dim * data.chans};`).join("")}
+		return size;
+	}
+
+	// returns the size of the snapshot consumed, or 0 if it doesn't belong to this app:
+	size_t setstate(oopsy::GenDaisy& daisy, const char * state) {
+		${name}::State& gen = *(${name}::State *)daisy.gen;
+		if (${name}::setstate((CommonState *)&gen, state)) return 0;
+		size_t size = ${name}::getstatesize((CommonState *)&gen);
+		${preset_datas(app.patch).map(data=>`
+		if (gen.${data.cname}.dim * gen.${data.cname}.channels >= ${data.dim * data.chans}) memcpy(gen.${data.cname}.mData, state + size, sizeof(float)*${data.dim * data.chans});
+		size += sizeof(float)*${data.dim * data.chans};`).join("")}
+		${gen.params.map(name=>nodes[name]).map(node=>`
+		${node.varname} = gen.${node.cname};`).join("")}
+		return size;
+	}
+
+	size_t morphstate(oopsy::GenDaisy& daisy, const char * a, const char * b, float mix) {
+		${name}::State& gen = *(${name}::State *)daisy.gen;
+		if (genlib_morphstate((CommonState *)&gen, a, b, mix, &${name}::setparameter)) return 0;
+		size_t size = ${name}::getstatesize((CommonState *)&gen);
+		${preset_datas(app.patch).map(data=>`
+		if (gen.${data.cname}.dim * gen.${data.cname}.channels >= ${data.dim * data.chans}) {
+			const float * da = (const float *)(a + size);
+			const float * db = (const float *)(b + size);
+			float * dst = gen.${data.cname}.mData;
+			for (int i=0; i<${data.dim * data.chans}; i++) dst[i] = da[i] + mix*(db[i] - da[i]);
+		}
+		size += sizeof(float)*${data.dim * data.chans};`).join("")}
+		${gen.params.map(name=>nodes[name]).map(node=>`
+		${node.varname} = gen.${node.cname};`).join("")}
+		return size;
+	}
+	` : ""}
 };`
 	app.cpp = {
 		union: `App_${name} app_${name};`,
 		appdef: `{"${name}", []()->void { oopsy::daisy.reset(apps.app_${name}); } },`,
+		hostdef: `{"${name}", oopsy::render<App_${name}> },`,
 		struct: struct,
 	}
 	return app
 }
+
+// [data] small enough to be included in preset snapshots:
+function preset_datas(patch) {
+	return patch.datas.filter(data => data.dim * data.chans <= PRESET_DATA_MAX)
+}
+
+// bytes of a preset snapshot: the genlib state (header & float params), then any small [data]
+function preset_size(patch) {
+	return 8 + 4*patch.params.length + preset_datas(patch).reduce((sum, data) => sum + 4*data.dim*data.chans, 0)
+}
+
+// wraps several apps into one app, running them all in the same audio callback
+// "serial": each app processes the outputs of the previous app, in-place in the hardware output buffers
+// "parallel": each app processes the hardware inputs, and all app outputs are summed
+function generate_chain(apps, hardware, mode) {
+	const defines = hardware.defines
+	const name = apps.map(app => app.patch.name).join("_")
+	const label = apps.map(app => app.patch.name).join(mode == "serial" ? ">" : "+")
+	const stages = apps.map(app => ({
+		name: app.patch.name,
+		member: `app_${app.patch.name}`,
+		gen: `gen_${app.patch.name}`,
+		param_offset: app.param_offset,
+		param_count: app.gen.params.length,
+	}))
+	// select the first param not mapped to hardware, across all stages:
+	const param_selected = Math.max(0, [].concat(...apps.map(app => app.gen.params.map(name => app.nodes[name].src))).indexOf(undefined))
+	const has_generic_midi_in = apps.some(app => app.has_generic_midi_in)
+	const has_generic_midi_thru = apps.some(app => app.has_generic_midi_thru)
+
+	const struct = `
+
+struct Chain_${name} : public oopsy::App<Chain_${name}> {
+	${stages.map(stage=>`
+	App_${stage.name} ${stage.member};
+	void * ${stage.gen};`).join("")}
+	${mode == "parallel" ? `
+	// shared by all parallel stages after the first, to be summed into the hardware outputs:
+	float * chain_outs[OOPSY_IO_COUNT];` : ""}
+
+	void init(oopsy::GenDaisy& daisy) {
+		int param_count = 0;
+		${stages.map(stage=>`
+		${stage.member}.init(daisy);
+		${stage.gen} = daisy.gen;
+		param_count += daisy.param_count;`).join("")}
+		daisy.param_count = param_count;
+		${mode == "parallel" ? `
+		for (int c=0; c<OOPSY_IO_COUNT; c++) chain_outs[c] = oopsy::scratch_buffer();` : ""}
+		${(defines.OOPSY_HAS_PARAM_VIEW) ? `daisy.param_selected = ${param_selected};`:``}
+	}
+
+	OOPSY_ITCM_FLATTEN void audioCallback(oopsy::GenDaisy& daisy, daisy::AudioHandle::InputBuffer hardware_ins, daisy::AudioHandle::OutputBuffer hardware_outs, size_t size) {
+		Daisy& hardware = daisy.hardware;
+		${hardware.inserts.filter(o => o.where == "audio").map(o => o.code).join("\n\t")}
+		${stages.map((stage, i)=>`
+		daisy.gen = ${stage.gen};
+		${i == 0 ? `${stage.member}.audioCallback(daisy, hardware_ins, hardware_outs, size);`
+		: mode == "serial" ? `${stage.member}.audioCallback(daisy, hardware_outs, hardware_outs, size); // in-place`
+		: `${stage.member}.audioCallback(daisy, hardware_ins, chain_outs, size);
+		for (int c=0; c<OOPSY_IO_COUNT; c++) {
+			float * out = hardware_outs[c];
+			const float * src = chain_outs[c];
+			for (size_t j=0; j<size; j++) out[j] += src[j];
+		}`}`).join("")}
+		${hardware.inserts.filter(o => o.where == "post_audio").map(o => o.code).join("\n\t")}
+		${defines.OOPSY_TARGET_SEED ? "hardware.PostProcess();" : ""}
+	}
+
+	void mainloopCallback(oopsy::GenDaisy& daisy, uint32_t t, uint32_t dt) {
+		Daisy& hardware = daisy.hardware;
+		${hardware.inserts.filter(o => o.where == "main").map(o => o.code).join("\n\t")}
+		${stages.map(stage=>`
+		daisy.gen = ${stage.gen};
+		${stage.member}.mainloopCallback(daisy, t, dt);`).join("")}
+		${defines.OOPSY_TARGET_USES_MIDI_UART ? `
+		while(daisy.uart.Readable()) {
+			uint8_t byte = daisy.uart.PopRx();
+			if (byte >= 128) { // status byte
+				${stages.map(stage=>`
+				${stage.member}.midiStatus(daisy, byte);`).join("")}
+				if (byte == 0xFF) { // reset event -> go to bootloader
+					daisy.log("reboot");
+					daisy::System::ResetToBootloader();
+				} 
+				if (byte <= 240 || byte == 247) {
+					daisy.midi.status = byte; 
+					daisy.midi.lastbyte = 255; // means 'no bytes received'
+				}
+			} else {
+				daisy.midi.lastbyte = !daisy.midi.lastbyte; 
+				daisy.midi.byte[daisy.midi.lastbyte] = byte;
+				${stages.map(stage=>`
+				${stage.member}.midiMessage(daisy);`).join("")}
+			}
+			${has_generic_midi_in ? `
+			${has_generic_midi_thru ? `daisy.midi_message1(byte); // thru` : ``}
+			if (daisy.midi_in_written < OOPSY_BLOCK_SIZE) {
+				// scale (0, 255) to (0.0, 1.0) to protect hardware from accidental patching
+				daisy.midi_in_data[daisy.midi_in_written] = byte / 256.0f;
+				daisy.midi_in_written++;
+			}` : ""}
+			daisy.midi_in_active = 1;
+		}` : "// no midi input handling"}
+	}
+
+	void displayCallback(oopsy::GenDaisy& daisy, uint32_t t, uint32_t dt) {
+		Daisy& hardware = daisy.hardware;
+		${hardware.inserts.filter(o => o.where == "display").map(o => o.code).join("\n\t")}
+		${stages.map(stage=>`
+		daisy.gen = ${stage.gen};
+		${stage.member}.displayCallback(daisy, t, dt);`).join("")}
+		${defines.OOPSY_TARGET_SEED ? "hardware.Display();" : ""}
+	}
+
+	${defines.OOPSY_TARGET_HAS_OLED && defines.OOPSY_HAS_PARAM_VIEW ? `
+	void paramCallback(oopsy::GenDaisy& daisy, int idx, char * label, int len, bool tweak) {
+		${stages.filter(stage => stage.param_count).map(stage=>`
+		if (idx < ${stage.param_offset + stage.param_count}) return ${stage.member}.paramCallback(daisy, idx - ${stage.param_offset}, label, len, tweak);`).join("")}
+	}
+	` : ""}
+	${defines.OOPSY_USE_PRESETS ? `
+	// the snapshot of a chain is the snapshots of each stage, one after another:
+	size_t getstate(oopsy::GenDaisy& daisy, char * state) {
+		size_t size = 0;
+		${stages.map(stage=>`
+		daisy.gen = ${stage.gen};
+		size += ${stage.member}.getstate(daisy, state + size);`).join("")}
+		return size;
+	}
+
+	size_t setstate(oopsy::GenDaisy& daisy, const char * state) {
+		size_t size = 0, n;
+		${stages.map(stage=>`
+		daisy.gen = ${stage.gen};
+		if (!(n = ${stage.member}.setstate(daisy, state + size))) return 0;
+		size += n;`).join("")}
+		return size;
+	}
+
+	size_t morphstate(oopsy::GenDaisy& daisy, const char * a, const char * b, float mix) {
+		size_t size = 0, n;
+		${stages.map(stage=>`
+		daisy.gen = ${stage.gen};
+		if (!(n = ${stage.member}.morphstate(daisy, a + size, b + size, mix))) return 0;
+		size += n;`).join("")}
+		return size;
+	}
+	` : ""}
+};`
+	return {
+		name: name,
+		cpp: {
+			union: `Chain_${name} chain_${name};`,
+			appdef: `{"${label}", []()->void { oopsy::daisy.reset(apps.chain_${name}); } },`,
+			hostdef: `{"${name}", oopsy::render<Chain_${name}> },`,
+			struct: struct,
+		}
+	}
+}
@@ -0,0 +1,157 @@
+#!/usr/bin/env node
+
+/*
+	Regression tests for oopsy, using host renders (see `render` in oopsy.js)
+
+	For each case in regress/regress.json, all the cpps are rendered (with any oopsy options of the case, e.g. poly4) at each samplerate & blocksize,
+	then every output is compared against its golden WAV in regress/golden/<case>/,
+	and the time per block is compared against regress/perf.json
+
+	Each render is repeated (at least `repeats` times, and for at least `repeat_ms` in total) and timed by its fastest repeat,
+	and perf.json also keeps how far the median repeat was from the fastest, as a measure of the noise.
+	A render only fails as slower if it is more than `slowdown` percent slower,
+	and also slower by more than twice the noise of the blessed and current timings together.
+
+	node regress.js 			check renders & performance
+	node regress.js bless 		store the current renders & performance as the new reference
+
+	options:
+	exact 			outputs must match the golden WAVs bit for bit
+	snr=<dB> 		outputs must be within this signal-to-noise ratio of the golden WAVs (default from regress.json)
+	slowdown=<%>	fail if any render is this much slower than in perf.json, beyond the noise (default from regress.json)
+	noperf 			don't check performance (e.g. on a different machine than the one that was blessed)
+
+	Timings are only comparable on the same machine, so perf.json should be blessed on the machine that checks it.
+	(test.sh runs with noperf, so a performance check is an explicit step)
+*/
+const fs = require("fs"),
+	path = require("path");
+const oopsy = require("./oopsy.js");
+
+const regress_path = path.join(__dirname, "regress")
+const golden_path = path.join(regress_path, "golden")
+const perf_path = path.join(regress_path, "perf.json")
+
+// returns the samples of a WAV written by the host render, as a Float32Array of interleaved frames:
+function read_wav(file) {
+	const buf = fs.readFileSync(file)
+	let offset = 12
+	while (offset + 8 <= buf.length) {
+		const id = buf.toString("ascii", offset, offset+4)
+		const size = buf.readUInt32LE(offset+4)
+		if (id == "data") {
+			const data = new Float32Array(size/4)
+			for (let i=0; i<data.length; i++) data[i] = buf.readFloatLE(offset + 8 + i*4)
+			return data
+		}
+		offset += 8 + size + (size & 1)
+	}
+	throw new Error(`no data in ${file}`)
+}
+
+// signal-to-noise ratio in dB of `output` against `golden`, or Infinity if they are identical:
+function snr(golden, output) {
+	if (golden.length != output.length) return -Infinity
+	let signal = 0, noise = 0
+	for (let i=0; i<golden.length; i++) {
+		const err = output[i] - golden[i]
+		signal += golden[i]*golden[i]
+		noise += err*err
+	}
+	if (noise == 0) return Infinity
+	return 10*Math.log10((signal || Number.MIN_VALUE) / noise)
+}
+
+function run(...args) {
+	const config = JSON.parse(fs.readFileSync(path.join(regress_path, "regress.json"), "utf8"))
+	let bless = false, exact = false, checkperf = true
+	let min_snr = config.snr
+	let slowdown = config.slowdown
+	args.forEach(arg => {
+		let match
+		if (arg == "bless") bless = true
+		else if (arg == "exact") exact = true
+		else if (arg == "noperf") checkperf = false
+		else if (match = arg.match(/^snr=([\d.]+)$/)) min_snr = +match[1]
+		else if (match = arg.match(/^slowdown=([\d.]+)$/)) slowdown = +match[1]
+		else console.warn(`unexpected argument ${arg}`)
+	})
+
+	const perf = fs.existsSync(perf_path) ? JSON.parse(fs.readFileSync(perf_path, "utf8")) : {}
+	let failures = []
+	let checked = 0, passed = 0
+
+	config.cases.forEach(test => {
+		const cpps = test.cpps.map(cpp => path.join(__dirname, cpp))
+		const missing = cpps.filter(cpp => !fs.existsSync(cpp))
+		if (missing.length) {
+			console.warn(`regress: skipping ${test.name}, missing ${missing.join(", ")}`)
+			return
+		}
+		// goldens are blessed per machine, so a fresh checkout may have none yet:
+		const case_path = path.join(golden_path, test.name)
+		if (!bless && !fs.existsSync(case_path)) {
+			console.warn(`regress: skipping ${test.name}, no golden outputs (run "node regress.js bless" to create them)`)
+			return
+		}
+		const jobs = oopsy(
+			"render", ...cpps,
+			...(test.input ? [path.join(__dirname, test.input)] : []),
+			...(test.script ? [path.join(__dirname, test.script)] : []),
+			...test.samplerates.map(khz => `${khz}kHz`),
+			...test.blocksizes.map(n => `block${n}`),
+			...(test.options || []),
+			`repeat${config.repeats}`,
+			`repeat${config.repeat_ms}ms`
+		)
+		if (!jobs) {
+			failures.push(`${test.name}: render failed`)
+			return
+		}
+		jobs.forEach(job => {
+			const key = `${test.name}/${job.file}`
+			const golden = path.join(case_path, job.file)
+			if (bless) {
+				fs.mkdirSync(case_path, {recursive: true})
+				fs.copyFileSync(job.path, golden)
+				perf[key] = { ns: Math.round(job.ns_per_block), spread: Math.round(job.ns_spread) }
+				return
+			}
+			checked++
+			const failed = failures.length
+			if (!fs.existsSync(golden)) {
+				failures.push(`${key}: no golden output, run "node regress.js bless" to create it`)
+			} else {
+				const ratio = snr(read_wav(golden), read_wav(job.path))
+				if (exact ? ratio != Infinity : ratio < min_snr) {
+					failures.push(`${key}: output differs from golden, SNR ${ratio.toFixed(1)} dB`)
+				}
+			}
+			if (checkperf && perf[key]) {
+				const ref = perf[key]
+				const change = 100*(job.ns_per_block - ref.ns)/ref.ns
+				const noise = 2*(ref.spread + job.ns_spread)
+				console.log(`regress: ${key} ${Math.round(job.ns_per_block)} ns/block (${change >= 0 ? "+" : ""}${change.toFixed(1)}%, noise ${Math.round(noise)} ns, ${job.repeats} repeats)`)
+				if (change > slowdown && job.ns_per_block - ref.ns > noise) {
+					failures.push(`${key}: ${change.toFixed(1)}% slower than ${ref.ns} ns/block`)
+				}
+			}
+			if (failures.length == failed) passed++
+		})
+	})
+
+	failures.forEach(s => console.log(`regress FAIL ${s}`))
+	if (bless) {
+		fs.writeFileSync(perf_path, JSON.stringify(perf, null, "\t"), "utf8")
+		console.log(`regress: blessed ${Object.keys(perf).length} renders`)
+	} else {
+		console.log(`regress: ${passed} of ${checked} renders passed`)
+	}
+	return failures.length ? 1 : 0
+}
+
+if (require.main === module) {
+	process.exit(run(...process.argv.slice(2)))
+} else {
+	module.exports = run;
+}
@@ -0,0 +1,161 @@
+// a feedback delay and a one-pole lowpass, for idle, resampling and chains
+// (a small hand-written stand-in for a gen~ export, used by regress.js)
+#include "genlib.h"
+#include "genlib_exportfunctions.h"
+#include "genlib_ops.h"
+
+namespace echo {
+
+static const int GENLIB_LOOPCOUNT_BAIL = 100000;
+
+typedef struct State {
+	CommonState __commonstate;
+	Delay m_delay_3;
+	t_sample m_history_4;
+	int __exception;
+	int vectorsize;
+	t_sample m_knob1_time_1;
+	t_sample m_knob2_feedback_2;
+	t_sample samplerate;
+	inline void reset(t_param __sr, int __vs) {
+		__exception = 0;
+		vectorsize = __vs;
+		samplerate = __sr;
+		m_knob1_time_1 = ((t_sample)0.05);
+		m_knob2_feedback_2 = ((t_sample)0.5);
+		m_history_4 = ((int)0);
+		m_delay_3.reset("m_delay_3", samplerate);
+		genlib_reset_complete(this);
+	};
+	inline int perform(t_sample ** __ins, t_sample ** __outs, int __n) {
+		vectorsize = __n;
+		const t_sample * __in1 = __ins[0];
+		const t_sample * __in2 = __ins[1];
+		t_sample * __out1 = __outs[0];
+		t_sample * __out2 = __outs[1];
+		if (__exception) return __exception;
+		else if (( (__in1 == 0) || (__in2 == 0) || (__out1 == 0) || (__out2 == 0) )) {
+			__exception = GENLIB_ERR_NULL_BUFFER;
+			return __exception;
+		}
+		while ((__n--)) {
+			const t_sample in1 = (*(__in1++));
+			const t_sample in2 = (*(__in2++));
+			t_sample tap = m_delay_3.read_linear(m_knob1_time_1 * samplerate);
+			t_sample fb = fixdenorm(in1 + tap * m_knob2_feedback_2);
+			m_delay_3.write(fb);
+			m_history_4 = fixdenorm(m_history_4 + (in2 - m_history_4) * 0.1);
+			(*(__out1++)) = fb;
+			(*(__out2++)) = m_history_4;
+			m_delay_3.step();
+		};
+		return __exception;
+	};
+	inline void set_knob1_time(t_param _value) {
+		m_knob1_time_1 = (_value < 0.01 ? 0.01 : (_value > 1 ? 1 : _value));
+	};
+	inline void set_knob2_feedback(t_param _value) {
+		m_knob2_feedback_2 = (_value < 0 ? 0 : (_value > 0.95 ? 0.95 : _value));
+	};
+} State;
+
+int gen_kernel_numins = 2;
+int gen_kernel_numouts = 2;
+
+int num_inputs() { return gen_kernel_numins; }
+int num_outputs() { return gen_kernel_numouts; }
+int num_params() { return 2; }
+
+static const char *gen_kernel_innames[] = { "in1", "in2" };
+static const char *gen_kernel_outnames[] = { "out1", "out2" };
+
+int perform(CommonState *cself, t_sample **ins, long numins, t_sample **outs, long numouts, long n) {
+	State* self = (State *)cself;
+	return self->perform(ins, outs, n);
+}
+
+void reset(CommonState *cself) {
+	State* self = (State *)cself;
+	self->reset(cself->sr, cself->vs);
+}
+
+void setparameter(CommonState *cself, long index, t_param value, void *ref) {
+	State *self = (State *)cself;
+	switch (index) {
+		case 0: self->set_knob1_time(value); break;
+		case 1: self->set_knob2_feedback(value); break;
+		default: break;
+	}
+}
+
+void getparameter(CommonState *cself, long index, t_param *value) {
+	State *self = (State *)cself;
+	switch (index) {
+		case 0: *value = self->m_knob1_time_1; break;
+		case 1: *value = self->m_knob2_feedback_2; break;
+		default: break;
+	}
+}
+
+size_t getstatesize(CommonState *cself) {
+	return genlib_getstatesize(cself, &getparameter);
+}
+
+short getstate(CommonState *cself, char *state) {
+	return genlib_getstate(cself, state, &getparameter);
+}
+
+short setstate(CommonState *cself, const char *state) {
+	return genlib_setstate(cself, state, &setparameter);
+}
+
+void * create(t_param sr, long vs) {
+	State *self = new State;
+	self->reset(sr, vs);
+	ParamInfo *pi;
+	self->__commonstate.inputnames = gen_kernel_innames;
+	self->__commonstate.outputnames = gen_kernel_outnames;
+	self->__commonstate.numins = gen_kernel_numins;
+	self->__commonstate.numouts = gen_kernel_numouts;
+	self->__commonstate.sr = sr;
+	self->__commonstate.vs = vs;
+	self->__commonstate.params = (ParamInfo *)genlib_sysmem_newptr(2 * sizeof(ParamInfo));
+	self->__commonstate.numparams = 2;
+	// initialize parameter 0 ("m_knob1_time_1")
+	pi = self->__commonstate.params + 0;
+	pi->name = "knob1_time";
+	pi->paramtype = GENLIB_PARAMTYPE_FLOAT;
+	pi->defaultvalue = self->m_knob1_time_1;
+	pi->defaultref = 0;
+	pi->hasinputminmax = false;
+	pi->inputmin = 0;
+	pi->inputmax = 1;
+	pi->hasminmax = true;
+	pi->outputmin = 0.01;
+	pi->outputmax = 1;
+	pi->exp = 0;
+	pi->units = "";		// no units defined
+	// initialize parameter 1 ("m_knob2_feedback_2")
+	pi = self->__commonstate.params + 1;
+	pi->name = "knob2_feedback";
+	pi->paramtype = GENLIB_PARAMTYPE_FLOAT;
+	pi->defaultvalue = self->m_knob2_feedback_2;
+	pi->defaultref = 0;
+	pi->hasinputminmax = false;
+	pi->inputmin = 0;
+	pi->inputmax = 1;
+	pi->hasminmax = true;
+	pi->outputmin = 0;
+	pi->outputmax = 0.95;
+	pi->exp = 0;
+	pi->units = "";		// no units defined
+	return self;
+}
+
+void destroy(CommonState *cself) {
+	State *self = (State *)cself;
+	genlib_sysmem_freeptr(cself->params);
+	delete self;
+}
+
+} // echo::
@@ -0,0 +1,184 @@
+// a tone whose level is set by MIDI CC 1, saved to preset 1 by gate 1 and recalled by gate 2
+// (a small hand-written stand-in for a gen~ export, used by regress.js)
+#include "genlib.h"
+#include "genlib_exportfunctions.h"
+#include "genlib_ops.h"
+
+namespace presets {
+
+static const int GENLIB_LOOPCOUNT_BAIL = 100000;
+
+typedef struct State {
+	CommonState __commonstate;
+	SineCycle __m_cycle_4;
+	SineData __sinedata;
+	t_sample m_preset_save_out_5;
+	t_sample m_preset_recall_out_6;
+	int __exception;
+	int vectorsize;
+	t_sample m_midi_cc1_1;
+	t_sample m_gate1_2;
+	t_sample m_gate2_3;
+	t_sample samplerate;
+	inline void reset(t_param __sr, int __vs) {
+		__exception = 0;
+		vectorsize = __vs;
+		samplerate = __sr;
+		m_midi_cc1_1 = ((t_sample)0.5);
+		m_gate1_2 = ((t_sample)0);
+		m_gate2_3 = ((t_sample)0);
+		m_preset_save_out_5 = ((int)0);
+		m_preset_recall_out_6 = ((int)0);
+		__m_cycle_4.reset(samplerate, 0);
+		genlib_reset_complete(this);
+	};
+	inline int perform(t_sample ** __ins, t_sample ** __outs, int __n) {
+		vectorsize = __n;
+		const t_sample * __in1 = __ins[0];
+		const t_sample * __in2 = __ins[1];
+		t_sample * __out1 = __outs[0];
+		t_sample * __out2 = __outs[1];
+		if (__exception) return __exception;
+		else if (( (__in1 == 0) || (__in2 == 0) || (__out1 == 0) || (__out2 == 0) )) {
+			__exception = GENLIB_ERR_NULL_BUFFER;
+			return __exception;
+		}
+		while ((__n--)) {
+			const t_sample in1 = (*(__in1++));
+			const t_sample in2 = (*(__in2++));
+			__m_cycle_4.freq(220);
+			t_sample osc = __m_cycle_4(__sinedata);
+			m_preset_save_out_5 = m_gate1_2;
+			m_preset_recall_out_6 = m_gate2_3;
+			(*(__out1++)) = osc * m_midi_cc1_1 * 0.5 + in1;
+			(*(__out2++)) = in2 * m_midi_cc1_1;
+		};
+		return __exception;
+	};
+	inline void set_midi_cc1(t_param _value) {
+		m_midi_cc1_1 = (_value < 0 ? 0 : (_value > 1 ? 1 : _value));
+	};
+	inline void set_gate1(t_param _value) {
+		m_gate1_2 = (_value < 0 ? 0 : (_value > 1 ? 1 : _value));
+	};
+	inline void set_gate2(t_param _value) {
+		m_gate2_3 = (_value < 0 ? 0 : (_value > 1 ? 1 : _value));
+	};
+} State;
+
+int gen_kernel_numins = 2;
+int gen_kernel_numouts = 2;
+
+int num_inputs() { return gen_kernel_numins; }
+int num_outputs() { return gen_kernel_numouts; }
+int num_params() { return 3; }
+
+static const char *gen_kernel_innames[] = { "in1", "in2" };
+static const char *gen_kernel_outnames[] = { "out1", "out2" };
+
+int perform(CommonState *cself, t_sample **ins, long numins, t_sample **outs, long numouts, long n) {
+	State* self = (State *)cself;
+	return self->perform(ins, outs, n);
+}
+
+void reset(CommonState *cself) {
+	State* self = (State *)cself;
+	self->reset(cself->sr, cself->vs);
+}
+
+void setparameter(CommonState *cself, long index, t_param value, void *ref) {
+	State *self = (State *)cself;
+	switch (index) {
+		case 0: self->set_midi_cc1(value); break;
+		case 1: self->set_gate1(value); break;
+		case 2: self->set_gate2(value); break;
+		default: break;
+	}
+}
+
+void getparameter(CommonState *cself, long index, t_param *value) {
+	State *self = (State *)cself;
+	switch (index) {
+		case 0: *value = self->m_midi_cc1_1; break;
+		case 1: *value = self->m_gate1_2; break;
+		case 2: *value = self->m_gate2_3; break;
+		default: break;
+	}
+}
+
+size_t getstatesize(CommonState *cself) {
+	return genlib_getstatesize(cself, &getparameter);
+}
+
+short getstate(CommonState *cself, char *state) {
+	return genlib_getstate(cself, state, &getparameter);
+}
+
+short setstate(CommonState *cself, const char *state) {
+	return genlib_setstate(cself, state, &setparameter);
+}
+
+void * create(t_param sr, long vs) {
+	State *self = new State;
+	self->reset(sr, vs);
+	ParamInfo *pi;
+	self->__commonstate.inputnames = gen_kernel_innames;
+	self->__commonstate.outputnames = gen_kernel_outnames;
+	self->__commonstate.numins = gen_kernel_numins;
+	self->__commonstate.numouts = gen_kernel_numouts;
+	self->__commonstate.sr = sr;
+	self->__commonstate.vs = vs;
+	self->__commonstate.params = (ParamInfo *)genlib_sysmem_newptr(3 * sizeof(ParamInfo));
+	self->__commonstate.numparams = 3;
+	// initialize parameter 0 ("m_midi_cc1_1")
+	pi = self->__commonstate.params + 0;
+	pi->name = "midi_cc1";
+	pi->paramtype = GENLIB_PARAMTYPE_FLOAT;
+	pi->defaultvalue = self->m_midi_cc1_1;
+	pi->defaultref = 0;
+	pi->hasinputminmax = false;
+	pi->inputmin = 0;
+	pi->inputmax = 1;
+	pi->hasminmax = true;
+	pi->outputmin = 0;
+	pi->outputmax = 1;
+	pi->exp = 0;
+	pi->units = "";		// no units defined
+	// initialize parameter 1 ("m_gate1_2")
+	pi = self->__commonstate.params + 1;
+	pi->name = "gate1";
+	pi->paramtype = GENLIB_PARAMTYPE_FLOAT;
+	pi->defaultvalue = self->m_gate1_2;
+	pi->defaultref = 0;
+	pi->hasinputminmax = false;
+	pi->inputmin = 0;
+	pi->inputmax = 1;
+	pi->hasminmax = true;
+	pi->outputmin = 0;
+	pi->outputmax = 1;
+	pi->exp = 0;
+	pi->units = "";		// no units defined
+	// initialize parameter 2 ("m_gate2_3")
+	pi = self->__commonstate.params + 2;
+	pi->name = "gate2";
+	pi->paramtype = GENLIB_PARAMTYPE_FLOAT;
+	pi->defaultvalue = self->m_gate2_3;
+	pi->defaultref = 0;
+	pi->hasinputminmax = false;
+	pi->inputmin = 0;
+	pi->inputmax = 1;
+	pi->hasminmax = true;
+	pi->outputmin = 0;
+	pi->outputmax = 1;
+	pi->exp = 0;
+	pi->units = "";		// no units defined
+	return self;
+}
+
+void destroy(CommonState *cself) {
+	State *self = (State *)cself;
+	genlib_sysmem_freeptr(cself->params);
+	delete self;
+}
+
+} // presets::
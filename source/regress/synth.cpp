@@ -0,0 +1,201 @@
+// a sawtooth voice with an envelope, for poly<N>
+// (a small hand-written stand-in for a gen~ export, used by regress.js)
+#include "genlib.h"
+#include "genlib_exportfunctions.h"
+#include "genlib_ops.h"
+
+namespace synth {
+
+static const int GENLIB_LOOPCOUNT_BAIL = 100000;
+
+typedef struct State {
+	CommonState __commonstate;
+	Phasor __m_phasor_5;
+	t_sample m_history_6;
+	int __exception;
+	int vectorsize;
+	t_sample m_voice_pitch_1;
+	t_sample m_voice_gate_2;
+	t_sample m_voice_vel_3;
+	t_sample m_gain_4;
+	t_sample samplerate;
+	inline void reset(t_param __sr, int __vs) {
+		__exception = 0;
+		vectorsize = __vs;
+		samplerate = __sr;
+		m_voice_pitch_1 = ((t_sample)60);
+		m_voice_gate_2 = ((t_sample)0);
+		m_voice_vel_3 = ((t_sample)0);
+		m_gain_4 = ((t_sample)1);
+		m_history_6 = ((int)0);
+		__m_phasor_5.reset(0);
+		genlib_reset_complete(this);
+	};
+	inline int perform(t_sample ** __ins, t_sample ** __outs, int __n) {
+		vectorsize = __n;
+		const t_sample * __in1 = __ins[0];
+		t_sample * __out1 = __outs[0];
+		t_sample * __out2 = __outs[1];
+		if (__exception) return __exception;
+		else if (( (__in1 == 0) || (__out1 == 0) || (__out2 == 0) )) {
+			__exception = GENLIB_ERR_NULL_BUFFER;
+			return __exception;
+		}
+		t_sample isr = (1 / samplerate);
+		t_sample freq = mtof(m_voice_pitch_1, 440);
+		while ((__n--)) {
+			const t_sample in1 = (*(__in1++));
+			t_sample ph = __m_phasor_5(freq, isr);
+			m_history_6 = fixdenorm((m_voice_gate_2 > 0) ? (m_history_6 + (1 - m_history_6) * 0.01) : (m_history_6 * 0.999));
+			t_sample s = (ph * 2 - 1) * m_history_6 * m_voice_vel_3 * m_gain_4 * 0.25;
+			(*(__out1++)) = s + in1 * 0;
+			(*(__out2++)) = s;
+		};
+		return __exception;
+	};
+	inline void set_voice_pitch(t_param _value) {
+		m_voice_pitch_1 = (_value < 0 ? 0 : (_value > 127 ? 127 : _value));
+	};
+	inline void set_voice_gate(t_param _value) {
+		m_voice_gate_2 = (_value < 0 ? 0 : (_value > 1 ? 1 : _value));
+	};
+	inline void set_voice_vel(t_param _value) {
+		m_voice_vel_3 = (_value < 0 ? 0 : (_value > 1 ? 1 : _value));
+	};
+	inline void set_gain(t_param _value) {
+		m_gain_4 = (_value < 0 ? 0 : (_value > 2 ? 2 : _value));
+	};
+} State;
+
+int gen_kernel_numins = 1;
+int gen_kernel_numouts = 2;
+
+int num_inputs() { return gen_kernel_numins; }
+int num_outputs() { return gen_kernel_numouts; }
+int num_params() { return 4; }
+
+static const char *gen_kernel_innames[] = { "in1" };
+static const char *gen_kernel_outnames[] = { "out1", "out2" };
+
+int perform(CommonState *cself, t_sample **ins, long numins, t_sample **outs, long numouts, long n) {
+	State* self = (State *)cself;
+	return self->perform(ins, outs, n);
+}
+
+void reset(CommonState *cself) {
+	State* self = (State *)cself;
+	self->reset(cself->sr, cself->vs);
+}
+
+void setparameter(CommonState *cself, long index, t_param value, void *ref) {
+	State *self = (State *)cself;
+	switch (index) {
+		case 0: self->set_voice_pitch(value); break;
+		case 1: self->set_voice_gate(value); break;
+		case 2: self->set_voice_vel(value); break;
+		case 3: self->set_gain(value); break;
+		default: break;
+	}
+}
+
+void getparameter(CommonState *cself, long index, t_param *value) {
+	State *self = (State *)cself;
+	switch (index) {
+		case 0: *value = self->m_voice_pitch_1; break;
+		case 1: *value = self->m_voice_gate_2; break;
+		case 2: *value = self->m_voice_vel_3; break;
+		case 3: *value = self->m_gain_4; break;
+		default: break;
+	}
+}
+
+size_t getstatesize(CommonState *cself) {
+	return genlib_getstatesize(cself, &getparameter);
+}
+
+short getstate(CommonState *cself, char *state) {
+	return genlib_getstate(cself, state, &getparameter);
+}
+
+short setstate(CommonState *cself, const char *state) {
+	return genlib_setstate(cself, state, &setparameter);
+}
+
+void * create(t_param sr, long vs) {
+	State *self = new State;
+	self->reset(sr, vs);
+	ParamInfo *pi;
+	self->__commonstate.inputnames = gen_kernel_innames;
+	self->__commonstate.outputnames = gen_kernel_outnames;
+	self->__commonstate.numins = gen_kernel_numins;
+	self->__commonstate.numouts = gen_kernel_numouts;
+	self->__commonstate.sr = sr;
+	self->__commonstate.vs = vs;
+	self->__commonstate.params = (ParamInfo *)genlib_sysmem_newptr(4 * sizeof(ParamInfo));
+	self->__commonstate.numparams = 4;
+	// initialize parameter 0 ("m_voice_pitch_1")
+	pi = self->__commonstate.params + 0;
+	pi->name = "voice_pitch";
+	pi->paramtype = GENLIB_PARAMTYPE_FLOAT;
+	pi->defaultvalue = self->m_voice_pitch_1;
+	pi->defaultref = 0;
+	pi->hasinputminmax = false;
+	pi->inputmin = 0;
+	pi->inputmax = 1;
+	pi->hasminmax = true;
+	pi->outputmin = 0;
+	pi->outputmax = 127;
+	pi->exp = 0;
+	pi->units = "";		// no units defined
+	// initialize parameter 1 ("m_voice_gate_2")
+	pi = self->__commonstate.params + 1;
+	pi->name = "voice_gate";
+	pi->paramtype = GENLIB_PARAMTYPE_FLOAT;
+	pi->defaultvalue = self->m_voice_gate_2;
+	pi->defaultref = 0;
+	pi->hasinputminmax = false;
+	pi->inputmin = 0;
+	pi->inputmax = 1;
+	pi->hasminmax = true;
+	pi->outputmin = 0;
+	pi->outputmax = 1;
+	pi->exp = 0;
+	pi->units = "";		// no units defined
+	// initialize parameter 2 ("m_voice_vel_3")
+	pi = self->__commonstate.params + 2;
+	pi->name = "voice_vel";
+	pi->paramtype = GENLIB_PARAMTYPE_FLOAT;
+	pi->defaultvalue = self->m_voice_vel_3;
+	pi->defaultref = 0;
+	pi->hasinputminmax = false;
+	pi->inputmin = 0;
+	pi->inputmax = 1;
+	pi->hasminmax = true;
+	pi->outputmin = 0;
+	pi->outputmax = 1;
+	pi->exp = 0;
+	pi->units = "";		// no units defined
+	// initialize parameter 3 ("m_gain_4")
+	pi = self->__commonstate.params + 3;
+	pi->name = "gain";
+	pi->paramtype = GENLIB_PARAMTYPE_FLOAT;
+	pi->defaultvalue = self->m_gain_4;
+	pi->defaultref = 0;
+	pi->hasinputminmax = false;
+	pi->inputmin = 0;
+	pi->inputmax = 1;
+	pi->hasminmax = true;
+	pi->outputmin = 0;
+	pi->outputmax = 2;
+	pi->exp = 0;
+	pi->units = "";		// no units defined
+	return self;
+}
+
+void destroy(CommonState *cself) {
+	State *self = (State *)cself;
+	genlib_sysmem_freeptr(cself->params);
+	delete self;
+}
+
+} // synth::
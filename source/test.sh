@@ -10,4 +10,5 @@ node oopsy.js ../templates/oopsy_bluemchen.cpp bluemchen && \
 node oopsy.js ../templates/oopsy_nehcmeulb.cpp nehcmeulb && \
 node oopsy.js ../examples/dattoro.cpp ../examples/gigaverb.cpp ../examples/crossover.cpp ../examples/midside.cpp && \
 node oopsy.js ../examples/midi_noteouts.cpp ../examples/midi_drum_ins.cpp ../examples/midi_drum_outs.cpp ../examples/midi_control_ins.cpp ../examples/midi_control_outs.cpp ../examples/midi_transport_ins.cpp  ../examples/midi_transport_outs.cpp && \
-node oopsy.js ../examples/sdcard.cpp
\ No newline at end of file
+node oopsy.js ../examples/sdcard.cpp && \
+node regress.js noperf
\ No newline at end of file